@@ -1,21 +1,52 @@
 /* event.c
- * ¼ϵͳʵ
- * ֻ׼ C ⣬ֱ PC ϱ
+ * 纯软件版事件系统实现
+ * 只依赖标准 C 库，可直接在 PC 上编译运行
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L     /* shm_open、mmap */
+#endif
+
 #include "event.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <time.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sched.h>
+#else
+#include <windows.h>
+#endif
 
-/* ȡ뼶ʱƽ̨ */
+/* 获取毫秒级时间戳（跨平台）：单调递增的墙上时间，进程睡眠或阻塞期间照常前进 */
 static uint32_t get_time_ms(void)
 {
-    return (uint32_t)(clock() * 1000 / CLOCKS_PER_SEC);
+#if !defined(_WIN32)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000u + (uint32_t)(ts.tv_nsec / 1000000);
+#else
+    return (uint32_t)GetTickCount();
+#endif
+}
+
+/* ==================== 时钟 ==================== */
+/* 时间戳来源可替换：默认使用 get_time_ms，测试和仿真可换成虚拟时钟手动推进 */
+static uint32_t default_clock(void* arg)
+{
+    (void)arg;
+    return get_time_ms();
 }
 
-/* Դӡ */
+static EventClock_t g_clock = default_clock;
+static void*        g_clock_arg = NULL;
+static uint32_t     g_virtual_time = 0;
+
+/* 调试打印 */
 static void debug_print(const char* format, ...)
 {
 #if EVENT_DEBUG_ENABLE
@@ -25,220 +56,2060 @@ static void debug_print(const char* format, ...)
     vprintf(format, args);
     printf("\n");
     va_end(args);
+#else
+    (void)format;
 #endif
 }
 
-/* ==================== ¼ ==================== */
+/* ==================== 原子操作 ==================== */
+/* 使用 GCC/Clang 内建原子操作，-std=c99 下同样可用 */
+#define ATOMIC_LOAD_RELAXED(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ATOMIC_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_LOAD_SEQ(p)          __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE_SEQ(p, v)      __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD_FETCH(p, v)      __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD_RELAXED(p, v)    __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+#define ATOMIC_CAS(p, expected, desired) \
+    __atomic_compare_exchange_n((p), (expected), (desired), 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define ATOMIC_FENCE()              __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define CACHE_ALIGNED   __attribute__((aligned(EVENT_CACHE_LINE_SIZE)))
+
+/* ==================== 事件队列 ==================== */
+/* 单生产者/单消费者环形队列
+ * - 生产者、消费者的索引各占一条缓存行，互不干扰
+ * - 各自缓存一份对方索引，只有在看似满/空时才去读对方的缓存行
+ * - 不再维护共享的 count，元素个数由 tail - head 得出
+ * 索引为自由递增的 32 位计数，取模靠掩码完成 */
+#define EVENT_QUEUE_MASK    (EVENT_QUEUE_SIZE - 1)
+
 typedef struct {
-    Event_t queue[EVENT_QUEUE_SIZE];
-    uint16_t head;
-    uint16_t tail;
-    uint16_t count;
+    CACHE_ALIGNED uint32_t tail;        /* 下一个写入位置，生产者写 */
+    CACHE_ALIGNED uint32_t head;        /* 下一个读取位置，消费者写 */
+    /* 事件槽位 */
+    CACHE_ALIGNED Event_t queue[EVENT_QUEUE_SIZE];
 } EventQueue_t;
 
-static EventQueue_t g_queue;
+/* 对方索引的副本只对本进程有意义，不放进队列（共享内存段中两个进程会互相覆盖），
+ * 各占一条缓存行，生产者只写 head_cache、消费者只写 tail_cache */
+typedef struct {
+    CACHE_ALIGNED uint32_t head_cache;  /* 生产者看到的 head 副本 */
+    CACHE_ALIGNED uint32_t tail_cache;  /* 消费者看到的 tail 副本 */
+} QueueCache_t;
+
+static EventQueue_t  g_local_queue;
+static EventQueue_t* g_queue = &g_local_queue;   /* 挂接共享内存段后指向段内的队列 */
+static QueueCache_t  g_queue_cache;
 
-/* в */
+/* 队列操作 */
 static int queue_init(void)
 {
-    memset(&g_queue, 0, sizeof(g_queue));
+    memset(g_queue, 0, sizeof(*g_queue));
+    memset(&g_queue_cache, 0, sizeof(g_queue_cache));
+    return 0;
+}
+
+/* 生产者：取得队尾空槽位，由调用者直接在槽位中填写事件，满时返回 NULL */
+static Event_t* queue_reserve(void)
+{
+    uint32_t tail = ATOMIC_LOAD_RELAXED(&g_queue->tail);
+    if (tail - g_queue_cache.head_cache >= EVENT_QUEUE_SIZE) {
+        g_queue_cache.head_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->head);
+        if (tail - g_queue_cache.head_cache >= EVENT_QUEUE_SIZE) {
+            return NULL;  // 满
+        }
+    }
+    return &g_queue->queue[tail & EVENT_QUEUE_MASK];
+}
+
+/* 生产者：提交 queue_reserve 取得的槽位 */
+static void queue_commit(void)
+{
+    uint32_t tail = ATOMIC_LOAD_RELAXED(&g_queue->tail);
+    ATOMIC_STORE_RELEASE(&g_queue->tail, tail + 1);
+}
+
+/* 消费者：取队首事件但不出队，槽位在 queue_release 之前不会被覆盖 */
+static Event_t* queue_peek(void)
+{
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    if (head == g_queue_cache.tail_cache) {
+        g_queue_cache.tail_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
+        if (head == g_queue_cache.tail_cache) {
+            return NULL;  // 空
+        }
+    }
+    return &g_queue->queue[head & EVENT_QUEUE_MASK];
+}
+
+/* 消费者：归还队首槽位 */
+static void queue_release(void)
+{
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    ATOMIC_STORE_RELEASE(&g_queue->head, head + 1);
+}
+
+/* 消费者：记录当前队尾并返回其前方待处理的事件数 */
+static uint32_t queue_snapshot(void)
+{
+    g_queue_cache.tail_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
+    return g_queue_cache.tail_cache - ATOMIC_LOAD_RELAXED(&g_queue->head);
+}
+
+/* 消费者：取队首事件，调用前须确认 queue_snapshot 返回值大于 0 */
+static Event_t* queue_front(void)
+{
+    return &g_queue->queue[ATOMIC_LOAD_RELAXED(&g_queue->head) & EVENT_QUEUE_MASK];
+}
+
+/* 消费者：丢弃所有未处理事件 */
+static void queue_discard(void)
+{
+    g_queue_cache.tail_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
+    ATOMIC_STORE_RELEASE(&g_queue->head, g_queue_cache.tail_cache);
+}
+
+static uint16_t queue_get_count(void)
+{
+    uint32_t head = ATOMIC_LOAD_ACQUIRE(&g_queue->head);
+    uint32_t tail = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
+    return (uint16_t)(tail - head);
+}
+
+/* ==================== 共享内存队列 ==================== */
+/* 把队列放进具名 POSIX 共享内存段，一个进程发布、另一个进程处理
+ * 事件数据内联在槽位中，不含指针，两个进程直接读写同一块内存，快路径上没有系统调用
+ * 段头记录布局参数，双方须用相同的 EVENT_QUEUE_SIZE、EVENT_DATA_SIZE_MAX 和缓存行大小编译 */
+#define EVENT_SHM_MAGIC     0x45564253u     /* "EVBS" */
+#define EVENT_SHM_VERSION   2
+
+typedef struct {
+    uint32_t magic;             /* 创建方最后写入，挂接方据此判断段已初始化完毕 */
+    uint16_t version;
+    uint16_t event_size;        /* sizeof(Event_t) */
+    uint32_t queue_size;        /* EVENT_QUEUE_SIZE */
+    uint32_t segment_size;      /* sizeof(ShmSegment_t)，包含对齐带来的差异 */
+} ShmHeader_t;
+
+typedef struct {
+    CACHE_ALIGNED ShmHeader_t header;
+    EventQueue_t queue;
+} ShmSegment_t;
+
+#define SHM_ROLE_NONE       0
+#define SHM_ROLE_PRODUCER   1
+#define SHM_ROLE_CONSUMER   2
+
+#if !defined(_WIN32)
+static ShmSegment_t* g_shm = NULL;
+static uint8_t g_shm_role = SHM_ROLE_NONE;     /* 本进程在共享段上的角色 */
+
+static int shm_map(const char* name, uint8_t create)
+{
+    int fd = shm_open(name, create ? (O_CREAT | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) {
+        debug_print("shm_open %s failed", name);
+        return -1;
+    }
+    if (create && ftruncate(fd, sizeof(ShmSegment_t)) != 0) {
+        close(fd);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmSegment_t)) {
+        close(fd);
+        return -1;
+    }
+    ShmSegment_t* seg = (ShmSegment_t*)mmap(NULL, sizeof(ShmSegment_t),
+                                             PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);      // 映射建立后描述符不再需要
+    if (seg == (ShmSegment_t*)MAP_FAILED) {
+        return -1;
+    }
+
+    if (create) {
+        ATOMIC_STORE_SEQ(&seg->header.magic, 0);
+        memset(&seg->queue, 0, sizeof(seg->queue));
+        seg->header.version = EVENT_SHM_VERSION;
+        seg->header.event_size = (uint16_t)sizeof(Event_t);
+        seg->header.queue_size = EVENT_QUEUE_SIZE;
+        seg->header.segment_size = (uint32_t)sizeof(ShmSegment_t);
+        ATOMIC_STORE_RELEASE(&seg->header.magic, EVENT_SHM_MAGIC);
+    } else if (ATOMIC_LOAD_ACQUIRE(&seg->header.magic) != EVENT_SHM_MAGIC ||
+               seg->header.version != EVENT_SHM_VERSION ||
+               seg->header.event_size != sizeof(Event_t) ||
+               seg->header.queue_size != EVENT_QUEUE_SIZE ||
+               seg->header.segment_size != sizeof(ShmSegment_t)) {
+        debug_print("Shared segment %s not ready or layout mismatch", name);
+        munmap(seg, sizeof(ShmSegment_t));
+        return -1;
+    }
+
+    g_shm = seg;
+    g_shm_role = SHM_ROLE_NONE;
+    g_queue = &seg->queue;
+    /* 本进程的副本从共享索引重新读取 */
+    g_queue_cache.head_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->head);
+    g_queue_cache.tail_cache = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
     return 0;
 }
 
-static int queue_push(void* event_data)
+static void shm_unmap(void)
+{
+    if (g_shm != NULL) {
+        munmap(g_shm, sizeof(ShmSegment_t));
+        g_shm = NULL;
+        g_shm_role = SHM_ROLE_NONE;
+        g_queue = &g_local_queue;
+        queue_init();
+    }
+}
+
+/* 共享段是单生产者/单消费者队列，一个进程只能承担其中一方：
+ * 首次发布或处理时确定角色，此后另一方的操作被拒绝 */
+static int shm_claim(uint8_t role)
 {
-    if (g_queue.count >= EVENT_QUEUE_SIZE) {
-        return -1;  // 
+    if (g_shm == NULL) {
+        return 0;
+    }
+    uint8_t cur = ATOMIC_LOAD_RELAXED(&g_shm_role);
+    while (cur == SHM_ROLE_NONE && !ATOMIC_CAS(&g_shm_role, &cur, role)) {
     }
-    Event_t* e = (Event_t*)event_data;
-    memcpy(&g_queue.queue[g_queue.tail], e, sizeof(Event_t));
-    g_queue.tail = (g_queue.tail + 1) % EVENT_QUEUE_SIZE;
-    g_queue.count++;
+    return (cur == SHM_ROLE_NONE || cur == role) ? 0 : -1;
+}
+#else
+static int shm_map(const char* name, uint8_t create)
+{
+    (void)name;
+    (void)create;
+    return -1;      // Windows 下暂不支持
+}
+
+static void shm_unmap(void)
+{
+}
+
+static int shm_claim(uint8_t role)
+{
+    (void)role;
     return 0;
 }
+#endif
+
+#if !EVENT_STATIC_SUBSCRIPTIONS
+/* ==================== 稀疏类型索引 ==================== */
+EVENT_STATIC_ASSERT(EVENT_MAX_COUNT <= 65535, type_slot_id_is_16_bits);
+EVENT_STATIC_ASSERT(EVENT_TYPE_PAGE_MAX <= 256, type_dir_has_256_pages);
+
+/* 16 位类型空间用两级页表定位类型槽位
+ * g_type_dir[高 8 位] 给出页号，页内 [低 8 位] 给出槽位号，二者都是 16 位、从 1 开始，0 表示不存在
+ * 页和槽位在首次订阅时分配、直到 EVENT_Init 才清空，内存只与用到的类型数相关，
+ * 读侧无锁，两次查表即可找到该类型的订阅者列表 */
+typedef struct {
+    struct SubscriberList* list;        /* NULL 表示无订阅者 */
+    Event_Type_t type;
+} TypeSlot_t;
+
+static uint16_t   g_type_dir[256];
+static uint16_t   g_type_pages[EVENT_TYPE_PAGE_MAX][256];
+static TypeSlot_t g_types[EVENT_MAX_COUNT];
+static uint16_t   g_type_page_count;    /* 以下两项只在持有写锁时访问 */
+static uint16_t   g_type_count;
+
+/* 写者锁：订阅表、类型索引等低频修改操作之间的串行化，分发线程从不获取 */
+static uint8_t g_writer_lock = 0;
+
+static void writer_lock(void)
+{
+    while (__atomic_test_and_set(&g_writer_lock, __ATOMIC_ACQUIRE)) {
+    }
+}
 
-static void* queue_pop(void)
+static void writer_unlock(void)
 {
-    if (g_queue.count == 0) {
+    __atomic_clear(&g_writer_lock, __ATOMIC_RELEASE);
+}
+
+static TypeSlot_t* type_lookup(Event_Type_t type)
+{
+    uint16_t page = ATOMIC_LOAD_ACQUIRE(&g_type_dir[type >> 8]);
+    if (page == 0) {
         return NULL;
     }
-    void* p = &g_queue.queue[g_queue.head];
-    g_queue.head = (g_queue.head + 1) % EVENT_QUEUE_SIZE;
-    g_queue.count--;
-    return p;
+    uint16_t slot = ATOMIC_LOAD_ACQUIRE(&g_type_pages[page - 1][type & 0xFF]);
+    return slot ? &g_types[slot - 1] : NULL;
 }
 
-static uint8_t queue_is_empty(void)
+/* 查找类型槽位，不存在时分配，须持有写锁 */
+static TypeSlot_t* type_acquire(Event_Type_t type)
 {
-    return g_queue.count == 0;
+    TypeSlot_t* t = type_lookup(type);
+    if (t != NULL) {
+        return t;
+    }
+    uint16_t page = g_type_dir[type >> 8];
+    if (page == 0) {
+        if (g_type_page_count >= EVENT_TYPE_PAGE_MAX) {
+            debug_print("Type page table full");
+            return NULL;
+        }
+        page = ++g_type_page_count;
+        ATOMIC_STORE_RELEASE(&g_type_dir[type >> 8], page);
+    }
+    if (g_type_count >= EVENT_MAX_COUNT) {
+        debug_print("Type slots full");
+        return NULL;
+    }
+    t = &g_types[g_type_count];
+    t->list = NULL;
+    t->type = type;
+    ATOMIC_STORE_RELEASE(&g_type_count, (uint16_t)(g_type_count + 1));    /* 分组分发线程会并发读取 */
+    ATOMIC_STORE_RELEASE(&g_type_pages[page - 1][type & 0xFF], g_type_count);
+    return t;
 }
 
-static uint16_t queue_get_count(void)
+static void type_index_init(void)
 {
-    return g_queue.count;
+    memset(g_type_dir, 0, sizeof(g_type_dir));
+    memset(g_type_pages, 0, sizeof(g_type_pages));
+    memset(g_types, 0, sizeof(g_types));
+    g_type_page_count = 0;
+    g_type_count = 0;
 }
 
-/* ==================== ۲ ==================== */
+/* ==================== 订阅者与观察者 ==================== */
+/* 订阅表采用写时复制（RCU 风格）：
+ * - 每个事件类型、全局观察者、通配订阅索引，各指向一份对象
+ * - 订阅时表尾有空位就地追加，取消订阅只把该项的回调置空（墓碑），两者都不分配对象；
+ *   只有表满或第一次订阅时才从对象池复制出压缩后的新对象、原子替换指针，旧对象进入待回收链
+ * - 分发线程不加锁，每轮处理开始时登记所处的纪元，每个事件（分组模式为每个类型）之间
+ *   刷新一次，结束时置为静止
+ * - 旧对象在分发线程越过其退役纪元（或处于静止）后回收，写者从不等待分发线程
+ * 只支持一个分发线程；写者之间用自旋锁串行化 */
+#define LIST_CAPACITY   ((EVENT_SUBSCRIBER_MAX > EVENT_OBSERVER_MAX) ? \
+                         EVENT_SUBSCRIBER_MAX : EVENT_OBSERVER_MAX)
+/* 每类型当前表 + 待回收表，外加观察者，再加一个事件的回调中反复订阅时的余量 */
+#define LIST_POOL_SIZE      (EVENT_MAX_COUNT * 2 + 2 + EVENT_RCU_SPARE)
+#define WILDCARD_POOL_SIZE  (3 + EVENT_RCU_SPARE / 2)
+
+EVENT_STATIC_ASSERT(EVENT_WILDCARD_MAX <= 32, wildcard_bitmap_is_32_bits);
+EVENT_STATIC_ASSERT(LIST_CAPACITY <= 32, filter_bitmap_is_32_bits);
+
 typedef struct {
     EventCallback_t callback;
     void* arg;
-    uint8_t used;
 } Subscriber_t;
 
+/* 可回收对象的公共头部，须作为结构体的第一个成员 */
+typedef struct RcuNode {
+    struct RcuNode* next;               /* 空闲链 / 待回收链 */
+    uint32_t retire_epoch;              /* 退役时的纪元 */
+} RcuNode_t;
+
+/* 对象池，只在持有写锁时访问 */
 typedef struct {
-    EventCallback_t callback;
-    void* arg;
-    uint8_t used;
-} Observer_t;
+    RcuNode_t* free;
+    RcuNode_t* retired;                 /* 按退役纪元从早到晚排列 */
+    RcuNode_t* retired_tail;
+} RcuPool_t;
 
-static Subscriber_t g_subscribers[EVENT_MAX_COUNT][EVENT_SUBSCRIBER_MAX];
-static Observer_t   g_observers[EVENT_OBSERVER_MAX];
+typedef struct SubscriberList {
+    RcuNode_t node;
+    uint8_t count;
+    uint32_t filtered;                  /* 第 i 位为 1 表示 items[i] 带过滤条件 */
+    Subscriber_t items[LIST_CAPACITY];
+    EventFilter_t filters[LIST_CAPACITY];
+} SubscriberList_t;
 
-static uint8_t g_initialized = 0;
+/* 通配订阅索引：把类型 ID 按 4 位一段拆成 4 段，
+ * accept[段][取值] 记录该段取该值时仍可能匹配的通配订阅位图，
+ * 发布时 4 次查表按位与即得匹配集合，与通配订阅数量无关 */
+typedef struct {
+    RcuNode_t node;
+    uint8_t count;
+    uint32_t accept[4][16];
+    Event_Type_t value[EVENT_WILDCARD_MAX];
+    Event_Type_t mask[EVENT_WILDCARD_MAX];
+    Subscriber_t items[EVENT_WILDCARD_MAX];
+} WildcardIndex_t;
 
-/* ==================== ʵ ==================== */
-int EVENT_Init(void)
+static SubscriberList_t* g_observers;
+static WildcardIndex_t*  g_wildcards;
+
+static SubscriberList_t g_list_objs[LIST_POOL_SIZE];
+static WildcardIndex_t  g_wildcard_objs[WILDCARD_POOL_SIZE];
+static RcuPool_t g_list_pool;
+static RcuPool_t g_wildcard_pool;
+
+static uint32_t g_epoch = 1;                    /* 全局纪元，每退役一个对象加一 */
+static uint32_t g_reader_epoch = 0;             /* 分发线程登记的纪元，0 表示静止 */
+static __thread uint8_t g_reader_thread = 0;    /* 本线程正处于读侧（即分发线程的回调中） */
+/* 分发线程进入读侧：登记当前纪元，此后读到的对象在登记期间不会被回收 */
+static void rcu_read_enter(void)
 {
-    queue_init();
-    memset(g_subscribers, 0, sizeof(g_subscribers));
-    memset(g_observers, 0, sizeof(g_observers));
-    g_initialized = 1;
-    debug_print("Event system initialized");
-    return 0;
+    g_reader_thread = 1;
+    ATOMIC_STORE_SEQ(&g_reader_epoch, ATOMIC_LOAD_SEQ(&g_epoch));
+    ATOMIC_FENCE();
 }
 
-int EVENT_Subscribe(Event_Type_t type, EventCallback_t callback, void* arg)
+/* 分发线程在两个事件之间不持有任何对象，纪元变化时重新登记，
+ * 使一轮处理中途退役的对象不必等到本轮结束才能回收 */
+static void rcu_quiescent(void)
+{
+    uint32_t epoch = ATOMIC_LOAD_SEQ(&g_epoch);
+    if (epoch != g_reader_epoch) {
+        ATOMIC_STORE_SEQ(&g_reader_epoch, epoch);
+        ATOMIC_FENCE();
+    }
+}
+
+static void rcu_read_exit(void)
+{
+    ATOMIC_STORE_RELEASE(&g_reader_epoch, 0);
+    g_reader_thread = 0;
+}
+
+/* 宽限期：推进纪元后等待分发线程静止或越过它，此后调用前已删除的订阅项不会再被调用，
+ * 也没有回调仍在使用它们；在分发线程的回调中调用时直接返回，
+ * 分发线程每次调用回调前都会重新读取订阅项，回调返回后不会再调用已删除的项 */
+static void rcu_synchronize(void)
+{
+    if (g_reader_thread) {
+        return;
+    }
+    uint32_t target = ATOMIC_ADD_FETCH(&g_epoch, 1);
+    for (;;) {
+        uint32_t reader = ATOMIC_LOAD_SEQ(&g_reader_epoch);
+        if (reader == 0 || (int32_t)(reader - target) >= 0) {
+            break;
+        }
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+static void rcu_pool_init(RcuPool_t* pool, void* objs, size_t size, int n)
+{
+    pool->free = NULL;
+    for (int i = n - 1; i >= 0; i--) {
+        RcuNode_t* node = (RcuNode_t*)((uint8_t*)objs + (size_t)i * size);
+        node->next = pool->free;
+        pool->free = node;
+    }
+    pool->retired = NULL;
+    pool->retired_tail = NULL;
+}
+
+/* 把分发线程已不可能再引用的旧对象放回空闲链 */
+static void rcu_reclaim(RcuPool_t* pool)
+{
+    uint32_t reader = ATOMIC_LOAD_SEQ(&g_reader_epoch);
+    while (pool->retired != NULL &&
+           (reader == 0 || (int32_t)(reader - pool->retired->retire_epoch) >= 0)) {
+        RcuNode_t* node = pool->retired;
+        pool->retired = node->next;
+        node->next = pool->free;
+        pool->free = node;
+    }
+    if (pool->retired == NULL) {
+        pool->retired_tail = NULL;
+    }
+}
+
+static void* rcu_alloc(RcuPool_t* pool)
+{
+    if (pool->free == NULL) {
+        rcu_reclaim(pool);
+        if (pool->free == NULL) {
+            debug_print("Subscriber table pool exhausted");
+            return NULL;
+        }
+    }
+    RcuNode_t* node = pool->free;
+    pool->free = node->next;
+    node->next = NULL;
+    return node;
+}
+
+/* 旧对象退役，调用前须已用 ATOMIC_STORE_SEQ 发布了替代它的新指针 */
+static void rcu_retire(RcuPool_t* pool, void* obj)
+{
+    RcuNode_t* node = (RcuNode_t*)obj;
+    if (node == NULL) {
+        return;
+    }
+    node->retire_epoch = ATOMIC_ADD_FETCH(&g_epoch, 1);
+    node->next = NULL;
+    if (pool->retired_tail) {
+        pool->retired_tail->next = node;
+    } else {
+        pool->retired = node;
+    }
+    pool->retired_tail = node;
+}
+
+static void rcu_init(void)
+{
+    rcu_pool_init(&g_list_pool, g_list_objs, sizeof(SubscriberList_t), LIST_POOL_SIZE);
+    rcu_pool_init(&g_wildcard_pool, g_wildcard_objs, sizeof(WildcardIndex_t), WILDCARD_POOL_SIZE);
+    g_epoch = 1;
+    g_reader_epoch = 0;
+}
+
+/* 统计未被删除的项数 */
+static int list_live(const SubscriberList_t* list)
+{
+    int live = 0;
+    for (int i = 0; i < list->count; i++) {
+        live += (list->items[i].callback != NULL);
+    }
+    return live;
+}
+
+/* 追加一项，filter 为 NULL 表示无过滤条件，须持有写锁
+ * 表尾还有空位时就地写入后再发布新的 count，分发线程读到新 count 时必然也读到新项；
+ * 表满（其中有已删除项）或还没有表时才复制出一份压缩后的新表 */
+static int list_insert(SubscriberList_t** slot, uint8_t max, EventCallback_t callback,
+                       void* arg, const EventFilter_t* filter)
 {
-    if (!g_initialized || type >= EVENT_MAX_COUNT || callback == NULL) {
+    SubscriberList_t* old = *slot;
+    if (old != NULL && list_live(old) >= max) {
         return -1;
     }
-    for (int i = 0; i < EVENT_SUBSCRIBER_MAX; i++) {
-        if (!g_subscribers[type][i].used) {
-            g_subscribers[type][i].callback = callback;
-            g_subscribers[type][i].arg = arg;
-            g_subscribers[type][i].used = 1;
-            debug_print("Subscribed to event %u", type);
-            return 0;
+    if (old != NULL && old->count < LIST_CAPACITY) {
+        uint8_t n = old->count;
+        old->items[n].callback = callback;
+        old->items[n].arg = arg;
+        if (filter) {
+            old->filters[n] = *filter;
+            ATOMIC_STORE_RELEASE(&old->filtered, old->filtered | (1u << n));
+        }
+        ATOMIC_STORE_RELEASE(&old->count, (uint8_t)(n + 1));
+        return 0;
+    }
+
+    SubscriberList_t* list = (SubscriberList_t*)rcu_alloc(&g_list_pool);
+    if (list == NULL) {
+        return -1;
+    }
+    uint8_t n = 0;
+    list->filtered = 0;
+    for (int i = 0; old != NULL && i < old->count; i++) {
+        if (old->items[i].callback != NULL) {
+            list->items[n] = old->items[i];
+            list->filters[n] = old->filters[i];
+            list->filtered |= ((old->filtered >> i) & 1u) << n;
+            n++;
         }
     }
-    return -1;  // 
+    list->items[n].callback = callback;
+    list->items[n].arg = arg;
+    if (filter) {
+        list->filters[n] = *filter;
+        list->filtered |= 1u << n;
+    }
+    list->count = n + 1;
+    ATOMIC_STORE_SEQ(slot, list);
+    rcu_retire(&g_list_pool, old);
+    return 0;
 }
 
-int EVENT_Unsubscribe(Event_Type_t type, EventCallback_t callback, void* arg)
+/* 删除匹配的一项，match_arg 为 0 时只比较回调，须持有写锁
+ * 只把该项的回调原子置空（墓碑），不分配新表，因此除"没有这一项"外不会失败；
+ * 墓碑在下一次复制时被压缩掉，分发线程跳过回调为空的项 */
+static int list_remove(SubscriberList_t** slot, EventCallback_t callback,
+                       void* arg, uint8_t match_arg)
 {
-    if (!g_initialized || type >= EVENT_MAX_COUNT || callback == NULL) {
+    SubscriberList_t* list = *slot;
+    if (list == NULL) {
         return -1;
     }
-    for (int i = 0; i < EVENT_SUBSCRIBER_MAX; i++) {
-        if (g_subscribers[type][i].used &&
-            g_subscribers[type][i].callback == callback &&
-            g_subscribers[type][i].arg == arg) {
-            g_subscribers[type][i].used = 0;
-            debug_print("Unsubscribed from event %u", type);
+    for (int i = 0; i < list->count; i++) {
+        if (list->items[i].callback == callback &&
+            (!match_arg || list->items[i].arg == arg)) {
+            ATOMIC_STORE_RELEASE(&list->items[i].callback, (EventCallback_t)NULL);
             return 0;
         }
     }
     return -1;
 }
 
-int EVENT_Publish(Event_Type_t type, Event_Priority_t priority,
-                  const void* data, uint8_t data_size)
+/* 检查并规范化过滤条件 */
+static int filter_prepare(const EventFilter_t* in, EventFilter_t* out)
 {
-    if (!g_initialized || type >= EVENT_MAX_COUNT) {
+    *out = *in;
+    if (out->op > EVENT_FILTER_GE || out->priority_min > out->priority_max) {
         return -1;
     }
-    if (data && data_size > EVENT_DATA_SIZE_MAX) {
+    if (out->op == EVENT_FILTER_ANY) {
+        out->offset = 0;
+        out->width = 0;
+        return 0;
+    }
+    if ((out->width != 1 && out->width != 2 && out->width != 4) ||
+        out->offset + out->width > EVENT_DATA_SIZE_MAX) {
         return -1;
     }
+    return 0;
+}
 
-    Event_t event;
-    memset(&event, 0, sizeof(event));
-    event.type = type;
-    event.priority = priority;
-    event.timestamp = get_time_ms();
-    if (data && data_size > 0) {
-        event.data_size = data_size;
-        memcpy(event.data, data, data_size);
+/* 取出过滤字段并与 mask 相与；数据不足时读到的是槽位中的旧字节，由调用者按 size_ok 排除 */
+static uint32_t filter_field(const EventFilter_t* f, const Event_t* event)
+{
+    const uint8_t* p = event->data + f->offset;
+    uint32_t field = 0;
+    if (f->big_endian) {
+        for (int i = 0; i < f->width; i++) {
+            field = (field << 8) | p[i];
+        }
+    } else {
+        for (int i = f->width - 1; i >= 0; i--) {
+            field = (field << 8) | p[i];
+        }
     }
+    return field & f->mask;
+}
 
-    if (queue_push(&event) != 0) {
-        debug_print("Event %u dropped (queue full)", type);
+/* 判断事件是否满足过滤条件，比较部分不含分支，便于编译器生成条件传送 */
+static int filter_match(const EventFilter_t* f, const Event_t* event)
+{
+    uint32_t field = filter_field(f, event);
+    int size_ok = (f->offset + f->width) <= event->data_size;
+    int prio_ok = (uint8_t)(event->priority - f->priority_min) <=
+                  (uint8_t)(f->priority_max - f->priority_min);
+    int eq = (field == f->value);
+    int lt = (field < f->value);
+    int data_ok = (f->op == EVENT_FILTER_ANY) |
+                  (size_ok & (((f->op == EVENT_FILTER_EQ) & eq) |
+                              ((f->op == EVENT_FILTER_NE) & !eq) |
+                              ((f->op == EVENT_FILTER_LT) & lt) |
+                              ((f->op == EVENT_FILTER_GE) & !lt)));
+    return prio_ok & data_ok;
+}
+
+/* 把第 i 项并入 accept 位图；就地追加时先写好订阅项再逐字发布，
+ * 分发线程读到某一位时必然也读到对应的订阅项 */
+static void wildcard_accept(WildcardIndex_t* w, int i)
+{
+    for (int n = 0; n < 4; n++) {
+        unsigned m = (w->mask[i] >> (n * 4)) & 0xF;
+        unsigned v = (w->value[i] >> (n * 4)) & 0xF;
+        for (unsigned x = 0; x < 16; x++) {
+            if ((x & m) == (v & m)) {
+                ATOMIC_STORE_RELEASE(&w->accept[n][x], w->accept[n][x] | (1u << i));
+            }
+        }
+    }
+}
+
+/* 增加（add=1）或删除（add=0）一项，须持有写锁
+ * 与 list_insert/list_remove 相同：有空位时就地追加，删除只留墓碑，
+ * 只有索引已满（其中有墓碑）或还没有索引时才复制压缩 */
+static int wildcard_update(Event_Type_t value, Event_Type_t mask,
+                           EventCallback_t callback, void* arg, uint8_t add)
+{
+    WildcardIndex_t* old = g_wildcards;
+    uint8_t n = old ? old->count : 0;
+    int live = 0;
+    for (int i = 0; i < n; i++) {
+        if (old->items[i].callback == NULL) {
+            continue;
+        }
+        if (!add && old->value[i] == value && old->mask[i] == mask &&
+            old->items[i].callback == callback && old->items[i].arg == arg) {
+            ATOMIC_STORE_RELEASE(&old->items[i].callback, (EventCallback_t)NULL);
+            return 0;
+        }
+        live++;
+    }
+    if (!add || live >= EVENT_WILDCARD_MAX) {
         return -1;
     }
 
-    debug_print("Event %u published", type);
+    WildcardIndex_t* w = old;
+    if (w == NULL || n >= EVENT_WILDCARD_MAX) {
+        w = (WildcardIndex_t*)rcu_alloc(&g_wildcard_pool);
+        if (w == NULL) {
+            return -1;
+        }
+        memset(w->accept, 0, sizeof(w->accept));
+        w->count = 0;
+        for (int i = 0; i < n; i++) {
+            if (old->items[i].callback != NULL) {
+                w->value[w->count] = old->value[i];
+                w->mask[w->count] = old->mask[i];
+                w->items[w->count] = old->items[i];
+                wildcard_accept(w, w->count);
+                w->count++;
+            }
+        }
+    }
+    uint8_t i = w->count;
+    w->value[i] = value;
+    w->mask[i] = mask;
+    w->items[i].callback = callback;
+    w->items[i].arg = arg;
+    w->count++;
+    wildcard_accept(w, i);
+    if (w != old) {
+        ATOMIC_STORE_SEQ(&g_wildcards, w);
+        rcu_retire(&g_wildcard_pool, old);
+    }
     return 0;
 }
 
-static void dispatch_event(Event_t* event)
+#else /* EVENT_STATIC_SUBSCRIPTIONS */
+/* ==================== 静态订阅表 ==================== */
+/* 订阅关系在编译期由 EVENT_STATIC_TABLE_FILE 中的 EVENT_STATIC_TABLE 宏给出，
+ * 这里展开成按类型分支的 switch，不再有任何运行期订阅表 */
+#include EVENT_STATIC_TABLE_FILE
+
+#define STATIC_CASE_BEGIN(type)             case (type): {
+#define STATIC_CASE_HANDLER(callback, arg)  callback(event, (void*)(arg));
+#define STATIC_CASE_END()                   } break;
+#define STATIC_SKIP_BEGIN(type)
+#define STATIC_SKIP_HANDLER(callback, arg)
+#define STATIC_SKIP_END()
+#define STATIC_OBSERVER(callback, arg)      callback(event, (void*)(arg));
+#define STATIC_SKIP_OBSERVER(callback, arg)
+
+static void rcu_read_enter(void)
+{
+}
+
+static void rcu_quiescent(void)
+{
+}
+
+static void rcu_read_exit(void)
+{
+}
+#endif /* EVENT_STATIC_SUBSCRIPTIONS */
+
+static uint8_t g_initialized = 0;
+static uint32_t g_init_count = 0;       /* EVENT_Init 的调用次数 */
+
+/* 处理状态，仅由调用 EVENT_Process 的线程访问 */
+static uint8_t g_process_mode = EVENT_PROCESS_DEFERRED;
+static uint8_t g_dispatching = 0;       /* 正在分发，回调中嵌套调用 EVENT_Process 将直接返回 */
+static uint8_t g_clear_pending = 0;     /* 回调中请求清空队列，待当前事件分发完再执行 */
+
+/* ==================== 信用流控 ==================== */
+/* 通道按 (type & mask) == value 匹配，取第一条启用的通道；发布线程取信用、分发线程还信用，
+ * 可用数用原子操作更新；归还时重新匹配类型，因此通道配置应在有在途事件时保持不变 */
+typedef struct {
+    Event_Type_t value;
+    Event_Type_t mask;
+    uint32_t capacity;                  /* 0 表示停用 */
+    int32_t available;                  /* 按差额调整容量时可能暂时为负 */
+    uint32_t denied;
+} CreditChannel_t;
+
+static CreditChannel_t g_credits[EVENT_CREDIT_MAX];
+static uint8_t         g_credit_count = 0;      /* 只增不减 */
+
+static CreditChannel_t* credit_match(Event_Type_t type)
 {
-    /* ¼Ͷ */
-    for (int i = 0; i < EVENT_SUBSCRIBER_MAX; i++) {
-        if (g_subscribers[event->type][i].used) {
-            g_subscribers[event->type][i].callback(event, g_subscribers[event->type][i].arg);
+    int n = ATOMIC_LOAD_ACQUIRE(&g_credit_count);
+    for (int i = 0; i < n; i++) {
+        CreditChannel_t* c = &g_credits[i];
+        if ((type & c->mask) == c->value && ATOMIC_LOAD_ACQUIRE(&c->capacity) != 0) {
+            return c;
         }
     }
-    /* ȫֹ۲ */
-    for (int i = 0; i < EVENT_OBSERVER_MAX; i++) {
-        if (g_observers[i].used) {
-            g_observers[i].callback(event, g_observers[i].arg);
+    return NULL;
+}
+
+/* 取走一个信用，成功返回 1 */
+static int credit_take(CreditChannel_t* c)
+{
+    int32_t old = ATOMIC_LOAD_RELAXED(&c->available);
+    while (old > 0) {
+        if (ATOMIC_CAS(&c->available, &old, old - 1)) {
+            return 1;
         }
     }
+    return 0;
 }
 
-int EVENT_Process(void)
+/* 分发线程：归还一个已分发或被丢弃事件的信用 */
+static void credit_return(Event_Type_t type)
 {
-    if (!g_initialized) return 0;
+    CreditChannel_t* c = credit_match(type);
+    if (c != NULL) {
+        ATOMIC_ADD_FETCH(&c->available, 1);
+    }
+}
 
-    int count = 0;
-    while (!queue_is_empty()) {
-        Event_t* e = (Event_t*)queue_pop();
-        if (e == NULL) break;
-        dispatch_event(e);
-        count++;
+/* 丢弃所有未处理事件，先归还它们占用的信用 */
+static void discard_events(void)
+{
+    if (ATOMIC_LOAD_RELAXED(&g_credit_count) == 0) {
+        queue_discard();
+        return;
     }
-    if (count > 0) {
-        debug_print("Processed %d events", count);
+    /* 以同一个队尾为界归还和丢弃，之后才入队的事件不受影响 */
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    uint32_t tail = ATOMIC_LOAD_ACQUIRE(&g_queue->tail);
+    for (uint32_t i = head; i != tail; i++) {
+        credit_return(g_queue->queue[i & EVENT_QUEUE_MASK].type);
     }
-    return count;
+    g_queue_cache.tail_cache = tail;
+    ATOMIC_STORE_RELEASE(&g_queue->head, tail);
 }
 
-int EVENT_ClearQueue(void)
+static void wait_yield(void)
 {
-    queue_init();
-    debug_print("Event queue cleared");
-    return 0;
+#if !defined(_WIN32)
+    sched_yield();
+#else
+    SwitchToThread();
+#endif
 }
 
-uint16_t EVENT_GetCount(void)
+#if EVENT_DEADLINE_ENABLE
+#define DEADLINE_GET(e)         ((e)->deadline)
+#define DEADLINE_SET(e, d)      ((e)->deadline = (d))
+#else
+#define DEADLINE_GET(e)         EVENT_DEADLINE_NONE
+#define DEADLINE_SET(e, d)      ((void)(d))
+#endif
+
+/* 直接在队列槽位中构造事件，只拷贝头部和实际使用的数据 */
+static int publish_event(Event_Type_t type, Event_Priority_t priority, uint32_t deadline,
+                         const void* data, uint8_t data_size)
 {
-    return queue_get_count();
+    if (shm_claim(SHM_ROLE_PRODUCER) != 0) {
+        debug_print("Event %u rejected (shared queue consumer)", type);
+        return -1;
+    }
+    CreditChannel_t* credit = NULL;
+    if (ATOMIC_LOAD_RELAXED(&g_credit_count) != 0) {
+        credit = credit_match(type);
+        if (credit != NULL && !credit_take(credit)) {
+            ATOMIC_ADD_RELAXED(&credit->denied, 1);
+            debug_print("Event %u rejected (no credit)", type);
+            return -1;
+        }
+    }
+    Event_t* event = queue_reserve();
+    if (event == NULL) {
+        if (credit != NULL) {
+            ATOMIC_ADD_FETCH(&credit->available, 1);
+        }
+        debug_print("Event %u dropped (queue full)", type);
+        return -1;
+    }
+    event->timestamp = g_clock(g_clock_arg);
+    DEADLINE_SET(event, deadline);
+    event->type = type;
+    event->priority = priority;
+    event->data_size = 0;
+    if (data && data_size > 0) {
+        event->data_size = data_size;
+        memcpy(event->data, data, data_size);
+    }
+    queue_commit();
+
+    debug_print("Event %u published", type);
+    return 0;
 }
 
-int EVENT_RegisterObserver(EventCallback_t callback, void* arg)
+/* ==================== 限流 ==================== */
+/* 令牌桶：规则按 (type & mask) == value 匹配，取第一条命中且启用的规则
+ * 桶状态把上次补充时间和剩余令牌打包成 64 位，用 CAS 更新，不需要锁
+ * 令牌以 1/1000 为单位计数，rate 个/秒恰好等于 rate 个单位/毫秒，补充没有舍入误差
+ * 时间取自总线时钟，换成虚拟时钟即可确定性地测试 */
+#define RATE_TOKEN_UNIT     1000u
+
+typedef struct {
+    Event_Type_t value;
+    Event_Type_t mask;
+    uint32_t rate;                      /* 每秒令牌数，0 表示规则停用 */
+    uint32_t burst;
+    uint8_t action;                     /* Event_RateAction_t */
+    Event_Priority_t demote_priority;
+    uint64_t state;                     /* 高 32 位：上次补充时间（ms），低 32 位：令牌（单位） */
+    EventRateStats_t stats;
+    uint8_t has_pending;                /* 合并模式下暂存的最新超额事件，仅发布线程访问 */
+    Event_t pending;
+} RateRule_t;
+
+static RateRule_t g_rate_rules[EVENT_RATE_LIMIT_MAX];
+static uint8_t    g_rate_rule_count = 0;    /* 规则只增不减，停用的规则 rate 为 0 */
+
+static RateRule_t* rate_match(Event_Type_t type)
 {
-    if (!g_initialized || callback == NULL) return -1;
-    for (int i = 0; i < EVENT_OBSERVER_MAX; i++) {
-        if (!g_observers[i].used) {
-            g_observers[i].callback = callback;
-            g_observers[i].arg = arg;
-            g_observers[i].used = 1;
-            debug_print("Observer registered");
-            return 0;
+    int n = ATOMIC_LOAD_ACQUIRE(&g_rate_rule_count);
+    for (int i = 0; i < n; i++) {
+        RateRule_t* r = &g_rate_rules[i];
+        if ((type & r->mask) == r->value && ATOMIC_LOAD_ACQUIRE(&r->rate) != 0) {
+            return r;
         }
     }
-    return -1;
+    return NULL;
 }
 
-int EVENT_UnregisterObserver(EventCallback_t callback)
+/* 补充令牌并尝试取走一个，成功返回 1 */
+static int rate_take(RateRule_t* r, uint32_t now)
 {
-    if (!g_initialized || callback == NULL) return -1;
-    for (int i = 0; i < EVENT_OBSERVER_MAX; i++) {
-        if (g_observers[i].used && g_observers[i].callback == callback) {
-            g_observers[i].used = 0;
-            debug_print("Observer unregistered");
-            return 0;
+    uint64_t cap = (uint64_t)r->burst * RATE_TOKEN_UNIT;
+    uint64_t old = ATOMIC_LOAD_RELAXED(&r->state);
+    for (;;) {
+        uint32_t last = (uint32_t)(old >> 32);
+        uint64_t tokens = (uint32_t)old + (uint64_t)(uint32_t)(now - last) * r->rate;
+        if (tokens > cap) {
+            tokens = cap;
         }
-    }
+        int ok = tokens >= RATE_TOKEN_UNIT;
+        if (ok) {
+            tokens -= RATE_TOKEN_UNIT;
+        }
+        uint64_t next = ((uint64_t)now << 32) | (uint32_t)tokens;
+        if (ATOMIC_CAS(&r->state, &old, next)) {
+            return ok;
+        }
+    }
+}
+
+/* 归还 rate_take 取走的令牌：取得令牌后入队失败（队列满、没有信用）时调用，
+ * 上次补充时间不变，令牌仍不超过桶容量 */
+static void rate_refund(RateRule_t* r)
+{
+    uint64_t cap = (uint64_t)r->burst * RATE_TOKEN_UNIT;
+    uint64_t old = ATOMIC_LOAD_RELAXED(&r->state);
+    for (;;) {
+        uint64_t tokens = (uint64_t)(uint32_t)old + RATE_TOKEN_UNIT;
+        if (tokens > cap) {
+            tokens = cap;
+        }
+        uint64_t next = (old & 0xFFFFFFFF00000000ull) | (uint32_t)tokens;
+        if (ATOMIC_CAS(&r->state, &old, next)) {
+            return;
+        }
+    }
+}
+
+/* 有令牌时发布暂存的合并事件，返回发布的数量；入队失败时归还令牌，事件继续暂存 */
+static int rate_flush(RateRule_t* r, uint32_t now)
+{
+    if (!r->has_pending || !rate_take(r, now)) {
+        return 0;
+    }
+    if (publish_event(r->pending.type, r->pending.priority, DEADLINE_GET(&r->pending),
+                      r->pending.data, r->pending.data_size) != 0) {
+        rate_refund(r);
+        return 0;
+    }
+    r->has_pending = 0;
+    ATOMIC_ADD_RELAXED(&r->stats.passed, 1);
+    return 1;
+}
+
+static int rate_publish(RateRule_t* r, Event_Type_t type, Event_Priority_t priority,
+                        uint32_t deadline, const void* data, uint8_t data_size)
+{
+    uint32_t now = g_clock(g_clock_arg);
+    /* 先尝试发出更早暂存的事件，保持先后顺序；它发不出去时当前事件也不会有令牌 */
+    rate_flush(r, now);
+    if (!r->has_pending && rate_take(r, now)) {
+        /* 只有真正入队才计为放行；入队失败时归还令牌，返回 -1 由调用者决定是否重试 */
+        if (publish_event(type, priority, deadline, data, data_size) != 0) {
+            rate_refund(r);
+            return -1;
+        }
+        ATOMIC_ADD_RELAXED(&r->stats.passed, 1);
+        return 0;
+    }
+
+    switch (r->action) {
+    case EVENT_RATE_DEMOTE:
+        ATOMIC_ADD_RELAXED(&r->stats.demoted, 1);
+        return publish_event(type, r->demote_priority, deadline, data, data_size);
+    case EVENT_RATE_COALESCE:
+        if (r->has_pending) {
+            ATOMIC_ADD_RELAXED(&r->stats.coalesced, 1);     // 被覆盖的旧事件
+        }
+        r->pending.type = type;
+        r->pending.priority = priority;
+        DEADLINE_SET(&r->pending, deadline);
+        r->pending.data_size = 0;
+        if (data && data_size > 0) {
+            r->pending.data_size = data_size;
+            memcpy(r->pending.data, data, data_size);
+        }
+        r->has_pending = 1;
+        return 0;
+    default:
+        ATOMIC_ADD_RELAXED(&r->stats.dropped, 1);
+        debug_print("Event %u dropped (rate limited)", type);
+        return -1;
+    }
+}
+
+/* ==================== 去抖与节流 ==================== */
+/* 按类型在入队前丢弃冗余事件，所有订阅者都不再需要各自过滤
+ * - 去抖：距上一个同类型事件（无论是否放行）不足 interval 时丢弃，一串抖动只放行第一个
+ * - 节流：距上一次放行不足 interval 时丢弃，持续输入时按固定间隔放行
+ * 状态只由发布线程修改 */
+typedef struct {
+    Event_Type_t type;
+    uint8_t mode;                       /* Event_DebounceMode_t，NONE 表示停用 */
+    uint8_t seen;                       /* last 有效 */
+    uint32_t interval;
+    uint32_t last;                      /* 去抖：上次到达时间；节流：上次放行时间 */
+    uint32_t suppressed;
+} DebounceGate_t;
+
+static DebounceGate_t g_gates[EVENT_DEBOUNCE_MAX];
+static uint8_t        g_gate_count = 0;     /* 只增不减 */
+
+static DebounceGate_t* gate_find(Event_Type_t type)
+{
+    int n = ATOMIC_LOAD_ACQUIRE(&g_gate_count);
+    for (int i = 0; i < n; i++) {
+        if (g_gates[i].type == type) {
+            return &g_gates[i];
+        }
+    }
+    return NULL;
+}
+
+/* 返回 1 表示该事件应被丢弃 */
+static int gate_suppress(Event_Type_t type)
+{
+    DebounceGate_t* g = gate_find(type);
+    if (g == NULL || g->mode == EVENT_DEBOUNCE_NONE) {
+        return 0;
+    }
+    uint32_t now = g_clock(g_clock_arg);
+    int close = g->seen && (uint32_t)(now - g->last) < g->interval;
+    if (!close || g->mode == EVENT_DEBOUNCE) {
+        g->last = now;
+    }
+    g->seen = 1;
+    if (close) {
+        ATOMIC_ADD_RELAXED(&g->suppressed, 1);
+        return 1;
+    }
+    return 0;
+}
+
+/* ==================== 定时器 ==================== */
+/* 由 EVENT_Process 在本轮分发结束后检查并回调，时间取自总线时钟
+ * 定时器状态只由调用 EVENT_Process 的线程访问；没有运行中的定时器时不读时钟 */
+typedef struct {
+    EventTimerCallback_t callback;      /* NULL 表示空闲 */
+    void* arg;
+    uint32_t due;
+    uint32_t period;                    /* 0 表示单次 */
+} Timer_t;
+
+static Timer_t  g_timers[EVENT_TIMER_MAX];
+static uint8_t  g_timer_active = 0;     /* 运行中的定时器数量 */
+static uint32_t g_timer_next_due;       /* 最早的到期时间，g_timer_active 为 0 时无效 */
+
+static void timer_update_next(void)
+{
+    uint32_t now = g_clock(g_clock_arg);
+    uint32_t best = 0;
+    int found = 0;
+    for (int i = 0; i < EVENT_TIMER_MAX; i++) {
+        if (g_timers[i].callback != NULL &&
+            (!found || (int32_t)(g_timers[i].due - now) < (int32_t)(best - now))) {
+            best = g_timers[i].due;
+            found = 1;
+        }
+    }
+    g_timer_next_due = best;
+}
+
+/* 回调所有已到期的定时器，周期定时器按原节拍顺延 */
+static void timer_run(void)
+{
+    uint32_t now = g_clock(g_clock_arg);
+    if ((int32_t)(now - g_timer_next_due) < 0) {
+        return;
+    }
+    for (int i = 0; i < EVENT_TIMER_MAX; i++) {
+        Timer_t* t = &g_timers[i];
+        if (t->callback == NULL || (int32_t)(now - t->due) < 0) {
+            continue;
+        }
+        EventTimerCallback_t callback = t->callback;
+        void* arg = t->arg;
+        if (t->period != 0) {
+            do {
+                t->due += t->period;
+            } while ((int32_t)(now - t->due) >= 0);
+        } else {
+            t->callback = NULL;
+            g_timer_active--;
+        }
+        callback(arg);      // 回调中可以启动或停止定时器
+    }
+    if (g_timer_active != 0) {
+        timer_update_next();
+    }
+}
+
+/* ==================== 截止时间 ==================== */
+/* 事件分发完成时检查是否已过截止时间；统计只由分发线程写入 */
+#if EVENT_DEADLINE_ENABLE
+static EventDeadlineStats_t g_deadline_stats;
+
+static void deadline_check(const Event_t* event)
+{
+    int32_t late = (int32_t)(g_clock(g_clock_arg) - event->deadline);
+    ATOMIC_ADD_RELAXED(&g_deadline_stats.dispatched, 1);
+    if (late > 0) {
+        ATOMIC_ADD_RELAXED(&g_deadline_stats.missed, 1);
+        if ((uint32_t)late > g_deadline_stats.max_late_ms) {
+            ATOMIC_STORE_RELEASE(&g_deadline_stats.max_late_ms, (uint32_t)late);
+        }
+        debug_print("Event %u missed deadline by %d ms", event->type, (int)late);
+    }
+}
+#endif
+
+/* 一个事件分发完成：统计截止时间、归还信用 */
+static void dispatch_done(const Event_t* event)
+{
+#if EVENT_DEADLINE_ENABLE
+    if (event->deadline != EVENT_DEADLINE_NONE) {
+        deadline_check(event);
+    }
+#endif
+    if (g_credit_count != 0) {
+        credit_return(event->type);
+    }
+}
+
+/* ==================== 公共函数实现 ==================== */
+int EVENT_Init(void)
+{
+    shm_unmap();
+    queue_init();
+#if !EVENT_STATIC_SUBSCRIPTIONS
+    type_index_init();
+    g_observers = NULL;
+    g_wildcards = NULL;
+    rcu_init();
+#endif
+    g_clock = default_clock;
+    g_clock_arg = NULL;
+    g_rate_rule_count = 0;
+    g_gate_count = 0;
+    g_credit_count = 0;
+#if EVENT_DEADLINE_ENABLE
+    memset(&g_deadline_stats, 0, sizeof(g_deadline_stats));
+#endif
+    memset(g_timers, 0, sizeof(g_timers));
+    g_timer_active = 0;
+    g_process_mode = EVENT_PROCESS_DEFERRED;
+    g_dispatching = 0;
+    g_clear_pending = 0;
+    g_initialized = 1;
+    ATOMIC_ADD_FETCH(&g_init_count, 1);
+    debug_print("Event system initialized");
+    return 0;
+}
+
+uint32_t EVENT_GetInitCount(void)
+{
+    return ATOMIC_LOAD_ACQUIRE(&g_init_count);
+}
+
+int EVENT_Subscribe(Event_Type_t type, EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)type;
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) {
+        return -1;
+    }
+    writer_lock();
+    TypeSlot_t* t = type_acquire(type);
+    int ret = t ? list_insert(&t->list, EVENT_SUBSCRIBER_MAX, callback, arg, NULL) : -1;
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Subscribed to event %u", type);
+    }
+    return ret;
+#endif
+}
+
+int EVENT_Unsubscribe(Event_Type_t type, EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)type;
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) {
+        return -1;
+    }
+    writer_lock();
+    TypeSlot_t* t = type_lookup(type);
+    int ret = t ? list_remove(&t->list, callback, arg, 1) : -1;
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Unsubscribed from event %u", type);
+    }
+    return ret;
+#endif
+}
+
+void EVENT_Synchronize(void)
+{
+#if !EVENT_STATIC_SUBSCRIPTIONS
+    rcu_synchronize();
+#endif
+}
+
+int EVENT_SubscribeFiltered(Event_Type_t type, const EventFilter_t* filter,
+                            EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)type;
+    (void)filter;
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    EventFilter_t f;
+    if (!g_initialized || callback == NULL || filter == NULL || filter_prepare(filter, &f) != 0) {
+        return -1;
+    }
+    writer_lock();
+    TypeSlot_t* t = type_acquire(type);
+    int ret = t ? list_insert(&t->list, EVENT_SUBSCRIBER_MAX, callback, arg, &f) : -1;
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Subscribed to event %u with filter", type);
+    }
+    return ret;
+#endif
+}
+
+int EVENT_SubscribeMask(Event_Type_t value, Event_Type_t mask,
+                        EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)value;
+    (void)mask;
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) {
+        return -1;
+    }
+    writer_lock();
+    int ret = wildcard_update(value, mask, callback, arg, 1);
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Subscribed to events %04X/%04X", value, mask);
+    }
+    return ret;
+#endif
+}
+
+int EVENT_UnsubscribeMask(Event_Type_t value, Event_Type_t mask,
+                          EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)value;
+    (void)mask;
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) {
+        return -1;
+    }
+    writer_lock();
+    int ret = wildcard_update(value, mask, callback, arg, 0);
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Unsubscribed from events %04X/%04X", value, mask);
+    }
+    return ret;
+#endif
+}
+
+/* 发布入口的公共部分：参数检查、去抖、限流，然后入队 */
+static int publish_checked(Event_Type_t type, Event_Priority_t priority, uint32_t deadline,
+                           const void* data, uint8_t data_size)
+{
+    if (!g_initialized) {
+        return -1;
+    }
+    if (data && data_size > EVENT_DATA_SIZE_MAX) {
+        return -1;
+    }
+
+    if (ATOMIC_LOAD_RELAXED(&g_gate_count) != 0 && gate_suppress(type)) {
+        debug_print("Event %u suppressed (debounce)", type);
+        return 0;
+    }
+    if (ATOMIC_LOAD_RELAXED(&g_rate_rule_count) != 0) {
+        RateRule_t* rule = rate_match(type);
+        if (rule != NULL) {
+            return rate_publish(rule, type, priority, deadline, data, data_size);
+        }
+    }
+    return publish_event(type, priority, deadline, data, data_size);
+}
+
+int EVENT_Publish(Event_Type_t type, Event_Priority_t priority,
+                  const void* data, uint8_t data_size)
+{
+    return publish_checked(type, priority, EVENT_DEADLINE_NONE, data, data_size);
+}
+
+int EVENT_PublishDeadline(Event_Type_t type, Event_Priority_t priority, uint32_t deadline_ms,
+                          const void* data, uint8_t data_size)
+{
+#if EVENT_DEADLINE_ENABLE
+    uint32_t deadline = g_clock(g_clock_arg) + deadline_ms;
+    if (deadline == EVENT_DEADLINE_NONE) {
+        deadline = 1;       // 0 留作"没有截止时间"，提前 1 ms 不影响排序
+    }
+    return publish_checked(type, priority, deadline, data, data_size);
+#else
+    (void)type; (void)priority; (void)deadline_ms; (void)data; (void)data_size;
+    return -1;
+#endif
+}
+
+int EVENT_GetDeadlineStats(EventDeadlineStats_t* stats)
+{
+#if EVENT_DEADLINE_ENABLE
+    if (stats == NULL) return -1;
+    stats->dispatched = ATOMIC_LOAD_RELAXED(&g_deadline_stats.dispatched);
+    stats->missed = ATOMIC_LOAD_RELAXED(&g_deadline_stats.missed);
+    stats->max_late_ms = ATOMIC_LOAD_RELAXED(&g_deadline_stats.max_late_ms);
+    return 0;
+#else
+    (void)stats;
     return -1;
+#endif
+}
+
+int EVENT_SetRateLimit(Event_Type_t value, Event_Type_t mask, const EventRateLimit_t* limit)
+{
+    if (!g_initialized) return -1;
+    if (limit != NULL && limit->rate != 0 &&
+        (limit->burst == 0 || limit->burst > UINT32_MAX / RATE_TOKEN_UNIT ||
+         limit->action > EVENT_RATE_DEMOTE)) {
+        return -1;
+    }
+    value &= mask;
+
+    int n = g_rate_rule_count;
+    RateRule_t* r = NULL;
+    for (int i = 0; i < n; i++) {
+        if (g_rate_rules[i].value == value && g_rate_rules[i].mask == mask) {
+            r = &g_rate_rules[i];
+            break;
+        }
+    }
+    if (limit == NULL || limit->rate == 0) {
+        if (r != NULL) {
+            ATOMIC_STORE_RELEASE(&r->rate, 0);
+        }
+        return 0;
+    }
+    if (r == NULL) {
+        if (n >= EVENT_RATE_LIMIT_MAX) {
+            debug_print("Rate limit table full");
+            return -1;
+        }
+        r = &g_rate_rules[n];
+        memset(r, 0, sizeof(*r));
+        r->value = value;
+        r->mask = mask;
+    }
+
+    /* 先停用再改参数，改完后重新启用，桶按满桶开始 */
+    ATOMIC_STORE_RELEASE(&r->rate, 0);
+    r->burst = limit->burst;
+    r->action = limit->action;
+    r->demote_priority = limit->demote_priority;
+    ATOMIC_STORE_RELEASE(&r->state, ((uint64_t)g_clock(g_clock_arg) << 32) |
+                                    (uint64_t)(limit->burst * RATE_TOKEN_UNIT));
+    ATOMIC_STORE_RELEASE(&r->rate, limit->rate);
+    if (r == &g_rate_rules[n]) {
+        ATOMIC_STORE_RELEASE(&g_rate_rule_count, (uint8_t)(n + 1));
+    }
+    return 0;
+}
+
+int EVENT_SetDebounce(Event_Type_t type, Event_DebounceMode_t mode, uint32_t interval_ms)
+{
+    if (!g_initialized || mode > EVENT_THROTTLE) return -1;
+    DebounceGate_t* g = gate_find(type);
+    if (g == NULL) {
+        if (mode == EVENT_DEBOUNCE_NONE) {
+            return 0;
+        }
+        int n = g_gate_count;
+        if (n >= EVENT_DEBOUNCE_MAX) {
+            debug_print("Debounce table full");
+            return -1;
+        }
+        g = &g_gates[n];
+        memset(g, 0, sizeof(*g));
+        g->type = type;
+        g->mode = (uint8_t)mode;
+        g->interval = interval_ms;
+        ATOMIC_STORE_RELEASE(&g_gate_count, (uint8_t)(n + 1));
+        return 0;
+    }
+    g->mode = (uint8_t)mode;
+    g->interval = interval_ms;
+    g->seen = 0;
+    return 0;
+}
+
+uint32_t EVENT_GetSuppressed(Event_Type_t type)
+{
+    const DebounceGate_t* g = gate_find(type);
+    return g ? ATOMIC_LOAD_RELAXED(&g->suppressed) : 0;
+}
+
+int EVENT_RateLimitFlush(void)
+{
+    int count = 0;
+    int n = ATOMIC_LOAD_ACQUIRE(&g_rate_rule_count);
+    uint32_t now = g_clock(g_clock_arg);
+    for (int i = 0; i < n; i++) {
+        count += rate_flush(&g_rate_rules[i], now);
+    }
+    return count;
+}
+
+int EVENT_GetRateStats(Event_Type_t value, Event_Type_t mask, EventRateStats_t* stats)
+{
+    if (stats == NULL) return -1;
+    value &= mask;
+    int n = ATOMIC_LOAD_ACQUIRE(&g_rate_rule_count);
+    for (int i = 0; i < n; i++) {
+        const RateRule_t* r = &g_rate_rules[i];
+        if (r->value == value && r->mask == mask) {
+            stats->passed = ATOMIC_LOAD_RELAXED(&r->stats.passed);
+            stats->dropped = ATOMIC_LOAD_RELAXED(&r->stats.dropped);
+            stats->coalesced = ATOMIC_LOAD_RELAXED(&r->stats.coalesced);
+            stats->demoted = ATOMIC_LOAD_RELAXED(&r->stats.demoted);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int EVENT_SetCredits(Event_Type_t value, Event_Type_t mask, uint32_t credits)
+{
+    if (!g_initialized || credits > INT32_MAX) return -1;
+    value &= mask;
+
+    int n = g_credit_count;
+    for (int i = 0; i < n; i++) {
+        CreditChannel_t* c = &g_credits[i];
+        if (c->value == value && c->mask == mask) {
+            uint32_t old = ATOMIC_LOAD_RELAXED(&c->capacity);
+            if (old == 0) {
+                ATOMIC_STORE_RELEASE(&c->available, (int32_t)credits);
+            } else {
+                ATOMIC_ADD_FETCH(&c->available, (int32_t)(credits - old));  // 在途事件归还后恰好回到新容量
+            }
+            ATOMIC_STORE_RELEASE(&c->capacity, credits);
+            return i;
+        }
+    }
+    if (credits == 0) {
+        return -1;
+    }
+    if (n >= EVENT_CREDIT_MAX) {
+        debug_print("Credit table full");
+        return -1;
+    }
+    CreditChannel_t* c = &g_credits[n];
+    memset(c, 0, sizeof(*c));
+    c->value = value;
+    c->mask = mask;
+    c->capacity = credits;
+    c->available = (int32_t)credits;
+    ATOMIC_STORE_RELEASE(&g_credit_count, (uint8_t)(n + 1));
+    return n;
+}
+
+int EVENT_GetCredits(int channel)
+{
+    if (channel < 0 || channel >= ATOMIC_LOAD_ACQUIRE(&g_credit_count)) return -1;
+    int32_t available = ATOMIC_LOAD_ACQUIRE(&g_credits[channel].available);
+    return available > 0 ? (int)available : 0;
+}
+
+int EVENT_CreditWait(int channel, uint32_t timeout_ms)
+{
+    if (channel < 0 || channel >= ATOMIC_LOAD_ACQUIRE(&g_credit_count)) return -1;
+    const CreditChannel_t* c = &g_credits[channel];
+    uint32_t start = get_time_ms();     // 超时按墙上时间计，不受总线时钟（可能是虚拟时钟）影响
+    while (ATOMIC_LOAD_ACQUIRE(&c->available) <= 0) {
+        if (ATOMIC_LOAD_RELAXED(&c->capacity) == 0) {
+            return 0;       // 已停用，发布不再受信用约束
+        }
+        if ((uint32_t)(get_time_ms() - start) >= timeout_ms) {
+            return -1;
+        }
+        wait_yield();
+    }
+    return 0;
+}
+
+uint32_t EVENT_GetCreditDenied(int channel)
+{
+    if (channel < 0 || channel >= ATOMIC_LOAD_ACQUIRE(&g_credit_count)) return 0;
+    return ATOMIC_LOAD_RELAXED(&g_credits[channel].denied);
+}
+
+#if EVENT_STATIC_SUBSCRIPTIONS
+/* 编译器可为 switch 生成跳转表，并内联表文件中可见的回调 */
+static void dispatch_event(Event_t* event)
+{
+    switch (event->type) {
+    EVENT_STATIC_TABLE(STATIC_CASE_BEGIN, STATIC_CASE_HANDLER, STATIC_CASE_END, STATIC_SKIP_OBSERVER)
+    default:
+        break;
+    }
+    EVENT_STATIC_TABLE(STATIC_SKIP_BEGIN, STATIC_SKIP_HANDLER, STATIC_SKIP_END, STATIC_OBSERVER)
+}
+#else
+/* 先取 count 再取 filtered，与 list_insert 就地追加时的发布顺序配对；回调为空的是已删除项 */
+static void dispatch_list(const SubscriberList_t* list, Event_t* event)
+{
+    if (list == NULL) {
+        return;
+    }
+    int count = ATOMIC_LOAD_ACQUIRE(&list->count);
+    uint32_t filtered = ATOMIC_LOAD_ACQUIRE(&list->filtered);
+    if (filtered == 0) {
+        for (int i = 0; i < count; i++) {
+            EventCallback_t callback = ATOMIC_LOAD_RELAXED(&list->items[i].callback);
+            if (callback != NULL) {
+                callback(event, list->items[i].arg);
+            }
+        }
+        return;
+    }
+    /* 带过滤条件的订阅者先就地判断，不满足的不产生回调 */
+    for (int i = 0; i < count; i++) {
+        EventCallback_t callback = ATOMIC_LOAD_RELAXED(&list->items[i].callback);
+        if (callback != NULL &&
+            (((filtered >> i) & 1u) == 0 || filter_match(&list->filters[i], event))) {
+            callback(event, list->items[i].arg);
+        }
+    }
+}
+
+/* 通配订阅者与全局观察者 */
+static void dispatch_shared(Event_t* event)
+{
+    const WildcardIndex_t* w = ATOMIC_LOAD_ACQUIRE(&g_wildcards);
+    if (w != NULL) {
+        Event_Type_t type = event->type;
+        uint32_t match = ATOMIC_LOAD_ACQUIRE(&w->accept[0][type & 0xF]) &
+                         ATOMIC_LOAD_ACQUIRE(&w->accept[1][(type >> 4) & 0xF]) &
+                         ATOMIC_LOAD_ACQUIRE(&w->accept[2][(type >> 8) & 0xF]) &
+                         ATOMIC_LOAD_ACQUIRE(&w->accept[3][type >> 12]);
+        while (match) {
+            int i = __builtin_ctz(match);
+            match &= match - 1;
+            EventCallback_t callback = ATOMIC_LOAD_RELAXED(&w->items[i].callback);
+            if (callback != NULL) {
+                callback(event, w->items[i].arg);
+            }
+        }
+    }
+    dispatch_list(ATOMIC_LOAD_ACQUIRE(&g_observers), event);
+}
+
+/* 调用前须处于 rcu_read_enter 与 rcu_read_exit 之间 */
+static void dispatch_event(Event_t* event)
+{
+    /* 事件类型订阅者 */
+    const TypeSlot_t* t = type_lookup(event->type);
+    if (t != NULL) {
+        dispatch_list(ATOMIC_LOAD_ACQUIRE(&t->list), event);
+    }
+    /* 通配订阅者、全局观察者 */
+    dispatch_shared(event);
+}
+
+/* 分组模式的批处理缓冲，仅分发线程访问 */
+static Event_t* g_batch_events[EVENT_QUEUE_SIZE];
+static uint16_t g_batch_key[EVENT_QUEUE_SIZE];
+static uint8_t  g_batch_match[EVENT_QUEUE_SIZE];
+static uint16_t g_batch_end[EVENT_MAX_COUNT + 1];
+
+/* 对一段同类型事件批量求过滤结果，分两步：
+ * - 逐个事件取出字段、优先级和长度是否足够，存成连续数组（事件经指针间接访问，这一步是标量的）
+ * - 比较方式在循环外选定，对数组做无分支、无提前退出的比较，这一步在 -O3 下由编译器向量化 */
+static uint32_t g_batch_field[EVENT_QUEUE_SIZE];
+static uint8_t  g_batch_prio[EVENT_QUEUE_SIZE];
+static uint8_t  g_batch_size_ok[EVENT_QUEUE_SIZE];
+
+static void filter_match_batch(const EventFilter_t* f, Event_t* const* events,
+                               int n, uint8_t* match)
+{
+    int end = f->offset + f->width;
+    for (int i = 0; i < n; i++) {
+        g_batch_field[i] = filter_field(f, events[i]);
+        g_batch_prio[i] = events[i]->priority;
+        g_batch_size_ok[i] = (uint8_t)(end <= events[i]->data_size);
+    }
+
+    const uint8_t lo = f->priority_min;
+    const uint8_t span = (uint8_t)(f->priority_max - f->priority_min);
+    const uint32_t value = f->value;
+    switch (f->op) {
+    case EVENT_FILTER_EQ:
+        for (int i = 0; i < n; i++) {
+            match[i] = (uint8_t)(((uint8_t)(g_batch_prio[i] - lo) <= span) & g_batch_size_ok[i] &
+                                 (g_batch_field[i] == value));
+        }
+        break;
+    case EVENT_FILTER_NE:
+        for (int i = 0; i < n; i++) {
+            match[i] = (uint8_t)(((uint8_t)(g_batch_prio[i] - lo) <= span) & g_batch_size_ok[i] &
+                                 (g_batch_field[i] != value));
+        }
+        break;
+    case EVENT_FILTER_LT:
+        for (int i = 0; i < n; i++) {
+            match[i] = (uint8_t)(((uint8_t)(g_batch_prio[i] - lo) <= span) & g_batch_size_ok[i] &
+                                 (g_batch_field[i] < value));
+        }
+        break;
+    case EVENT_FILTER_GE:
+        for (int i = 0; i < n; i++) {
+            match[i] = (uint8_t)(((uint8_t)(g_batch_prio[i] - lo) <= span) & g_batch_size_ok[i] &
+                                 (g_batch_field[i] >= value));
+        }
+        break;
+    default:    /* EVENT_FILTER_ANY */
+        for (int i = 0; i < n; i++) {
+            match[i] = (uint8_t)((uint8_t)(g_batch_prio[i] - lo) <= span);
+        }
+        break;
+    }
+}
+
+/* 把同一类型的一段事件交给该类型的订阅者：
+ * 逐个订阅者连续处理整段，回调代码和订阅表在这段时间内一直留在缓存中 */
+static void dispatch_run(const SubscriberList_t* list, Event_t* const* events, int n)
+{
+    if (list != NULL) {
+        int count = ATOMIC_LOAD_ACQUIRE(&list->count);
+        uint32_t filtered = ATOMIC_LOAD_ACQUIRE(&list->filtered);
+        for (int j = 0; j < count && !g_clear_pending; j++) {
+            EventCallback_t callback = ATOMIC_LOAD_RELAXED(&list->items[j].callback);
+            void* arg = list->items[j].arg;
+            if (callback == NULL) {
+                continue;
+            }
+            /* 每次调用前确认该项仍未删除，回调中取消订阅（含销毁自身）后不再被调用 */
+            if (((filtered >> j) & 1u) == 0) {
+                for (int i = 0; i < n && ATOMIC_LOAD_RELAXED(&list->items[j].callback) != NULL; i++) {
+                    callback(events[i], arg);
+                }
+            } else {
+                filter_match_batch(&list->filters[j], events, n, g_batch_match);
+                for (int i = 0; i < n && ATOMIC_LOAD_RELAXED(&list->items[j].callback) != NULL; i++) {
+                    if (g_batch_match[i]) {
+                        callback(events[i], arg);
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < n && !g_clear_pending; i++) {
+        dispatch_shared(events[i]);
+    }
+}
+
+/* 分组分发：队首 n 个事件按类型槽位做稳定计数排序，每种类型的事件连续分发，
+ * 同一类型内保持到达顺序；没有订阅者的类型归入 0 号桶，只交给通配订阅者和观察者
+ * 桶数在查找前读取一次，批处理期间其他线程新订阅的类型槽位超出桶数，同样归入 0 号桶，
+ * 新订阅者从下一批开始收到该类型的事件 */
+static void dispatch_grouped(uint32_t n)
+{
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    int buckets = ATOMIC_LOAD_ACQUIRE(&g_type_count) + 1;
+
+    memset(g_batch_end, 0, (size_t)buckets * sizeof(g_batch_end[0]));
+    for (uint32_t i = 0; i < n; i++) {
+        const TypeSlot_t* t = type_lookup(g_queue->queue[(head + i) & EVENT_QUEUE_MASK].type);
+        uint16_t key = t ? (uint16_t)(t - g_types + 1) : 0;
+        if (key >= buckets) {
+            key = 0;
+        }
+        g_batch_key[i] = key;
+        g_batch_end[key]++;
+    }
+    /* 前缀和得到各桶起点，散列后 g_batch_end[k] 恰为第 k 桶的终点 */
+    uint16_t start = 0;
+    for (int k = 0; k < buckets; k++) {
+        uint16_t c = g_batch_end[k];
+        g_batch_end[k] = start;
+        start += c;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        g_batch_events[g_batch_end[g_batch_key[i]]++] = &g_queue->queue[(head + i) & EVENT_QUEUE_MASK];
+    }
+
+    uint16_t begin = 0;
+    for (int k = 0; k < buckets && !g_clear_pending; k++) {
+        int len = g_batch_end[k] - begin;
+        if (len > 0) {
+            const SubscriberList_t* list = (k == 0) ? NULL : ATOMIC_LOAD_ACQUIRE(&g_types[k - 1].list);
+            dispatch_run(list, &g_batch_events[begin], len);
+            rcu_quiescent();
+        }
+        begin = g_batch_end[k];
+    }
+}
+#endif
+
+#if !EVENT_STATIC_SUBSCRIPTIONS || EVENT_DEADLINE_ENABLE
+/* 消费者：一次归还 n 个队首槽位 */
+static void queue_release_n(uint32_t n)
+{
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    ATOMIC_STORE_RELEASE(&g_queue->head, head + n);
+}
+#endif
+
+#if EVENT_DEADLINE_ENABLE
+/* EDF 模式的 4 叉最小堆，仅分发线程访问
+ * 键为 64 位整数：高 32 位是剩余时间（偏移成无符号以便直接比较，没有截止时间的取最大），
+ * 其后 8 位是反转的优先级，低 16 位是批内序号，比较一次整数即按截止时间、优先级、到达顺序排好
+ * 4 个子节点共 32 字节；堆从数组第 3 项开始存放，使每组子节点对齐到 32 字节，一次取数落在同一缓存行 */
+#define EDF_ARITY       4
+#define EDF_HEAP_SKEW   3
+
+EVENT_STATIC_ASSERT(EVENT_QUEUE_SIZE <= 65536, edf_batch_index_fits_16_bits);
+
+static CACHE_ALIGNED uint64_t g_edf_storage[EVENT_QUEUE_SIZE + EDF_HEAP_SKEW];
+
+static void edf_sift_down(uint64_t* heap, uint32_t n, uint32_t i)
+{
+    uint64_t key = heap[i];
+    for (;;) {
+        uint32_t first = i * EDF_ARITY + 1;
+        if (first >= n) {
+            break;
+        }
+        uint32_t last = first + EDF_ARITY < n ? first + EDF_ARITY : n;
+        uint32_t best = first;
+        for (uint32_t c = first + 1; c < last; c++) {
+            if (heap[c] < heap[best]) {
+                best = c;
+            }
+        }
+        if (heap[best] >= key) {
+            break;
+        }
+        heap[i] = heap[best];
+        i = best;
+    }
+    heap[i] = key;
+}
+
+/* 截止时间优先分发：队首 n 个事件建堆后依次取最早到期的分发，整批处理完再由调用者归还槽位 */
+static void dispatch_edf(uint32_t n)
+{
+    uint64_t* heap = g_edf_storage + EDF_HEAP_SKEW;
+    uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+    uint32_t now = g_clock(g_clock_arg);
+
+    for (uint32_t i = 0; i < n; i++) {
+        const Event_t* e = &g_queue->queue[(head + i) & EVENT_QUEUE_MASK];
+        uint32_t slack = (e->deadline == EVENT_DEADLINE_NONE) ? UINT32_MAX :
+                         ((uint32_t)(e->deadline - now) ^ 0x80000000u);
+        heap[i] = ((uint64_t)slack << 32) | ((uint32_t)(0xFFu - e->priority) << 16) | i;
+    }
+    for (uint32_t i = (n + EDF_ARITY - 2) / EDF_ARITY; i-- > 0; ) {
+        edf_sift_down(heap, n, i);
+    }
+
+    uint32_t size = n;
+    while (size > 0 && !g_clear_pending) {
+        Event_t* e = &g_queue->queue[(head + (uint32_t)(heap[0] & 0xFFFFu)) & EVENT_QUEUE_MASK];
+        heap[0] = heap[--size];
+        if (size > 0) {
+            edf_sift_down(heap, size, 0);
+        }
+        dispatch_event(e);
+        dispatch_done(e);
+        rcu_quiescent();
+    }
+    /* 回调中清空了队列：剩下的事件随整批一起丢弃，归还它们的信用 */
+    while (size > 0 && g_credit_count != 0) {
+        credit_return(g_queue->queue[(head + (uint32_t)(heap[--size] & 0xFFFFu)) & EVENT_QUEUE_MASK].type);
+    }
+}
+#endif
+
+int EVENT_Process(void)
+{
+    if (!g_initialized || g_dispatching || shm_claim(SHM_ROLE_CONSUMER) != 0) return 0;
+
+    int count = 0;
+    Event_t* e;
+    g_dispatching = 1;
+    rcu_read_enter();
+    if (g_process_mode == EVENT_PROCESS_IMMEDIATE) {
+        /* 立即模式：回调中新发布的事件在本轮一并处理，直到队列为空 */
+        while (!g_clear_pending && (e = queue_peek()) != NULL) {
+            dispatch_event(e);
+            dispatch_done(e);
+            queue_release();
+            rcu_quiescent();
+            count++;
+        }
+#if !EVENT_STATIC_SUBSCRIPTIONS
+    } else if (g_process_mode == EVENT_PROCESS_GROUPED) {
+        /* 分组模式：取出进入时已在队列中的一批事件，按类型分组后分发，整批处理完再归还槽位，
+         * 因此本轮回调中可用于再次发布的空间只有队列中原本空闲的部分 */
+        uint32_t pending = queue_snapshot();
+        if (pending > 0) {
+            dispatch_grouped(pending);
+            uint32_t head = ATOMIC_LOAD_RELAXED(&g_queue->head);
+            for (uint32_t i = 0; i < pending; i++) {
+                dispatch_done(&g_queue->queue[(head + i) & EVENT_QUEUE_MASK]);
+            }
+            queue_release_n(pending);
+            count = (int)pending;
+        }
+#endif
+#if EVENT_DEADLINE_ENABLE
+    } else if (g_process_mode == EVENT_PROCESS_EDF) {
+        /* 截止时间优先模式：取批方式与分组模式相同，批内按截止时间排序后分发 */
+        uint32_t pending = queue_snapshot();
+        if (pending > 0) {
+            dispatch_edf(pending);
+            queue_release_n(pending);
+            count = (int)pending;
+        }
+#endif
+    } else {
+        /* 延后模式：只处理进入时已在队列中的事件，
+         * 回调中新发布的事件写入已释放的槽位，留到下一次 EVENT_Process */
+        uint32_t pending = queue_snapshot();
+        while (pending > 0 && !g_clear_pending) {
+            e = queue_front();
+            dispatch_event(e);
+            dispatch_done(e);
+            queue_release();
+            rcu_quiescent();
+            pending--;
+            count++;
+        }
+    }
+    rcu_read_exit();
+    if (g_clear_pending) {
+        g_clear_pending = 0;
+        discard_events();
+    }
+    if (g_timer_active != 0) {
+        timer_run();
+    }
+    g_dispatching = 0;
+
+    if (count > 0) {
+        debug_print("Processed %d events", count);
+    }
+    return count;
+}
+
+int EVENT_SetProcessMode(Event_ProcessMode_t mode)
+{
+    if (mode != EVENT_PROCESS_DEFERRED && mode != EVENT_PROCESS_IMMEDIATE
+#if !EVENT_STATIC_SUBSCRIPTIONS
+        && mode != EVENT_PROCESS_GROUPED
+#endif
+#if EVENT_DEADLINE_ENABLE
+        && mode != EVENT_PROCESS_EDF
+#endif
+        ) {
+        return -1;
+    }
+    g_process_mode = (uint8_t)mode;
+    return 0;
+}
+
+int EVENT_SetClock(EventClock_t clock, void* arg)
+{
+    if (clock == NULL) {
+        g_clock = default_clock;
+        g_clock_arg = NULL;
+    } else {
+        g_clock = clock;
+        g_clock_arg = arg;
+    }
+    return 0;
+}
+
+EventClock_t EVENT_GetClock(void** arg)
+{
+    if (arg != NULL) {
+        *arg = g_clock_arg;
+    }
+    return g_clock == default_clock ? NULL : g_clock;
+}
+
+uint32_t EVENT_GetTime(void)
+{
+    return g_clock(g_clock_arg);
+}
+
+uint32_t EVENT_VirtualClock(void* arg)
+{
+    (void)arg;
+    return ATOMIC_LOAD_ACQUIRE(&g_virtual_time);
+}
+
+void EVENT_VirtualClockSet(uint32_t ms)
+{
+    ATOMIC_STORE_RELEASE(&g_virtual_time, ms);
+}
+
+void EVENT_VirtualClockAdvance(uint32_t ms)
+{
+    ATOMIC_ADD_FETCH(&g_virtual_time, ms);
+}
+
+int EVENT_TimerStart(uint32_t delay_ms, uint32_t period_ms, EventTimerCallback_t callback, void* arg)
+{
+    if (!g_initialized || callback == NULL) return -1;
+    for (int id = 0; id < EVENT_TIMER_MAX; id++) {
+        Timer_t* t = &g_timers[id];
+        if (t->callback == NULL) {
+            t->arg = arg;
+            t->due = g_clock(g_clock_arg) + delay_ms;
+            t->period = period_ms;
+            t->callback = callback;
+            g_timer_active++;
+            timer_update_next();
+            return id;
+        }
+    }
+    debug_print("Timer table full");
+    return -1;
+}
+
+int EVENT_TimerStop(int id)
+{
+    if (id < 0 || id >= EVENT_TIMER_MAX || g_timers[id].callback == NULL) {
+        return -1;
+    }
+    g_timers[id].callback = NULL;
+    g_timer_active--;
+    if (g_timer_active != 0) {
+        timer_update_next();
+    }
+    return 0;
+}
+
+int EVENT_ClearQueue(void)
+{
+    if (shm_claim(SHM_ROLE_CONSUMER) != 0) {
+        return -1;              // 共享段的发布进程不能移动 head
+    }
+    if (g_dispatching) {
+        g_clear_pending = 1;    // 分发过程中不能移动 head，延后到本轮结束
+        return 0;
+    }
+    discard_events();
+    debug_print("Event queue cleared");
+    return 0;
+}
+
+uint16_t EVENT_GetCount(void)
+{
+    return queue_get_count();
+}
+
+int EVENT_RegisterObserver(EventCallback_t callback, void* arg)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)callback;
+    (void)arg;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) return -1;
+    writer_lock();
+    int ret = list_insert(&g_observers, EVENT_OBSERVER_MAX, callback, arg, NULL);
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Observer registered");
+    }
+    return ret;
+#endif
+}
+
+int EVENT_UnregisterObserver(EventCallback_t callback)
+{
+#if EVENT_STATIC_SUBSCRIPTIONS
+    (void)callback;
+    return -1;      // 静态订阅模式下订阅关系在编译期确定
+#else
+    if (!g_initialized || callback == NULL) return -1;
+    writer_lock();
+    int ret = list_remove(&g_observers, callback, NULL, 0);
+    writer_unlock();
+    if (ret == 0) {
+        debug_print("Observer unregistered");
+    }
+    return ret;
+#endif
+}
+
+int EVENT_ShmOpen(const char* name, uint8_t create)
+{
+    if (!g_initialized || g_dispatching || name == NULL) return -1;
+    shm_unmap();
+    if (shm_map(name, create) != 0) {
+        return -1;
+    }
+    debug_print("Shared queue %s %s", name, create ? "created" : "attached");
+    return 0;
+}
+
+int EVENT_ShmClose(void)
+{
+    if (!g_initialized || g_dispatching) return -1;
+    shm_unmap();
+    return 0;
+}
+
+int EVENT_ShmUnlink(const char* name)
+{
+#if !defined(_WIN32)
+    if (name == NULL) return -1;
+    return shm_unlink(name) == 0 ? 0 : -1;
+#else
+    (void)name;
+    return -1;
+#endif
 }
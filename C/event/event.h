@@ -1,52 +1,305 @@
 /* event.h
- * ¼ϵͳͷļ
- *  PC е C κǶʽ
+ * 纯软件版事件系统头文件
+ * 适用于 PC 上运行的 C 程序，无任何嵌入式依赖
  */
 
 #ifndef __EVENT_H
 #define __EVENT_H
 
 #include <stdint.h>
+#include <stddef.h>
 
-/* ==================== ú ==================== */
-// ûɸҪ޸ֵ
-#define EVENT_MAX_COUNT         32    // ֵ֧¼
-#define EVENT_SUBSCRIBER_MAX    8     // ÿ¼ඩ
-#define EVENT_OBSERVER_MAX      4     // ȫֹ۲
-#define EVENT_QUEUE_SIZE        64    // ¼
-#define EVENT_DATA_SIZE_MAX     32    // ¼Яֽ
-#define EVENT_DEBUG_ENABLE      1     // 1=Դӡ0=ر
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-/* ==================== Ͷ ==================== */
+/* ==================== 配置宏 ==================== */
+// 用户可根据需要修改以下值（也可在编译命令中用 -D 覆盖）
+#ifndef EVENT_MAX_COUNT
+#define EVENT_MAX_COUNT         32    // 可同时拥有订阅者的事件类型数量（类型 ID 可取 0~65535）
+#endif
+#ifndef EVENT_TYPE_PAGE_MAX
+#define EVENT_TYPE_PAGE_MAX     8     // 类型索引页数，每页覆盖 256 个连续类型 ID
+#endif
+#ifndef EVENT_SUBSCRIBER_MAX
+#define EVENT_SUBSCRIBER_MAX    8     // 每个事件类型最多订阅者数量
+#endif
+#ifndef EVENT_WILDCARD_MAX
+#define EVENT_WILDCARD_MAX      8     // 通配/层级订阅最大数量（不超过 32）
+#endif
+#ifndef EVENT_OBSERVER_MAX
+#define EVENT_OBSERVER_MAX      4     // 全局观察者最大数量
+#endif
+#ifndef EVENT_RCU_SPARE
+#define EVENT_RCU_SPARE         8     // 单个事件的回调中订阅表可额外复制的次数（取消订阅不占用）
+#endif
+#ifndef EVENT_QUEUE_SIZE
+#define EVENT_QUEUE_SIZE        64    // 事件队列深度（必须是 2 的幂）
+#endif
+#ifndef EVENT_DATA_SIZE_MAX
+#define EVENT_DATA_SIZE_MAX     32    // 事件携带数据最大字节数
+#endif
+#ifndef EVENT_DEBUG_ENABLE
+#define EVENT_DEBUG_ENABLE      1     // 1=开启调试打印，0=关闭
+#endif
+#ifndef EVENT_STATIC_SUBSCRIPTIONS
+#define EVENT_STATIC_SUBSCRIPTIONS 0  // 1=使用编译期静态订阅表，运行期订阅接口全部返回 -1
+#endif
+/* 静态订阅表文件须定义宏 EVENT_STATIC_TABLE(BEGIN, HANDLER, END, OBSERVER)，
+ * 按类型分组写出 BEGIN(类型) HANDLER(回调, 参数)... END()，格式见 event_static_table.h */
+#ifndef EVENT_STATIC_TABLE_FILE
+#define EVENT_STATIC_TABLE_FILE "event_static_table.h"   // 静态订阅表所在头文件
+#endif
+#ifndef EVENT_RATE_LIMIT_MAX
+#define EVENT_RATE_LIMIT_MAX    8     // 限流规则最大数量
+#endif
+#ifndef EVENT_DEBOUNCE_MAX
+#define EVENT_DEBOUNCE_MAX      8     // 可配置去抖/节流的事件类型数量
+#endif
+#ifndef EVENT_TIMER_MAX
+#define EVENT_TIMER_MAX         8     // 同时运行的定时器数量
+#endif
+#ifndef EVENT_CREDIT_MAX
+#define EVENT_CREDIT_MAX        8     // 信用通道最大数量
+#endif
+#ifndef EVENT_DEADLINE_ENABLE
+#define EVENT_DEADLINE_ENABLE   0     // 1=事件头部增加 4 字节截止时间，支持 EDF 分发模式
+#endif
+#ifndef EVENT_CACHE_LINE_SIZE
+#define EVENT_CACHE_LINE_SIZE   64    // CPU 缓存行字节数，用于队列索引隔离
+#endif
+
+/* ==================== 工具宏 ==================== */
+/* C99 下的编译期断言：条件不成立时数组长度为 -1，编译报错 */
+#define EVENT_STATIC_ASSERT(cond, name) \
+    typedef char event_static_assert_##name[(cond) ? 1 : -1]
+
+EVENT_STATIC_ASSERT((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0,
+                    queue_size_must_be_power_of_two);
+
+/* ==================== 类型定义 ==================== */
 typedef uint16_t Event_Type_t;
 typedef uint8_t  Event_Priority_t;
 
+/* 事件结构：按字段宽度从大到小排列，头部共 8 字节（启用截止时间时 12 字节）且没有填充
+ * 头部之后紧跟数据，EVENT_DATA_SIZE_MAX 取 8 时整个事件正好 16 字节，
+ * 一条 64 字节缓存行可容纳 4 个事件 */
 typedef struct {
-    Event_Type_t type;                   /* ¼ */
-    Event_Priority_t priority;           /* ¼ȼδʹãչ */
-    uint32_t timestamp;                  /* ¼ʱms */
-    uint8_t data_size;                   /* ݴС */
-    uint8_t data[EVENT_DATA_SIZE_MAX];   /* ¼ */
+    uint32_t timestamp;                  /* 事件时间戳（ms） */
+#if EVENT_DEADLINE_ENABLE
+    uint32_t deadline;                   /* 截止时间（ms，总线时钟），EVENT_DEADLINE_NONE 表示没有 */
+#endif
+    Event_Type_t type;                   /* 事件类型 */
+    Event_Priority_t priority;           /* 事件优先级（暂未使用，可扩展） */
+    uint8_t data_size;                   /* 数据大小 */
+    uint8_t data[EVENT_DATA_SIZE_MAX];   /* 事件数据 */
 } Event_t;
 
-/* ¼ص */
+#define EVENT_HEADER_SIZE   offsetof(Event_t, data)   /* 事件头部字节数 */
+#define EVENT_DEADLINE_NONE 0u                        /* 没有截止时间 */
+#define EVENT_DEADLINE_BYTES (EVENT_DEADLINE_ENABLE ? 4 : 0)
+
+/* 布局检查：头部 8 字节（另加截止时间），类型/优先级/大小/时间戳可装进 16 字节之内，
+ * 整体大小只比数据区多出头部和 4 字节对齐 */
+EVENT_STATIC_ASSERT(offsetof(Event_t, type) == 4 + EVENT_DEADLINE_BYTES, event_type_offset);
+EVENT_STATIC_ASSERT(offsetof(Event_t, priority) == 6 + EVENT_DEADLINE_BYTES, event_priority_offset);
+EVENT_STATIC_ASSERT(offsetof(Event_t, data_size) == 7 + EVENT_DEADLINE_BYTES, event_data_size_offset);
+EVENT_STATIC_ASSERT(offsetof(Event_t, data) == 8 + EVENT_DEADLINE_BYTES, event_header_size);
+EVENT_STATIC_ASSERT(sizeof(Event_t) == ((8 + EVENT_DEADLINE_BYTES + EVENT_DATA_SIZE_MAX + 3) & ~3u),
+                    event_no_padding);
+
+/* 层级主题：把 16 位类型 ID 划分为 4/4/8 位三级，例如 "sensor/temp/+"
+ * 写作 EVENT_SubscribeMask(EVENT_TOPIC(SENSOR, TEMP, 0), EVENT_TOPIC_MASK_L2, ...)
+ * 使用 C++ 字符串主题（event_topic.hpp）时，一级主题 15 保留给散列得到的主题 ID */
+#define EVENT_TOPIC(l1, l2, l3)  ((Event_Type_t)((((l1) & 0xF) << 12) | \
+                                                 (((l2) & 0xF) << 8) | ((l3) & 0xFF)))
+#define EVENT_TOPIC_MASK_L1      0xF000   /* 匹配 "l1/+/+" */
+#define EVENT_TOPIC_MASK_L2      0xFF00   /* 匹配 "l1/l2/+" */
+#define EVENT_TOPIC_MASK_ALL     0xFFFF   /* 精确匹配 */
+
+/* 订阅过滤条件：由总线在调用回调之前就地判断，不满足的事件不会产生回调
+ * 取 data[offset] 起 width（1/2/4）字节为无符号字段，与 mask 相与后按 op 和 value 比较，
+ * 同时要求优先级位于 [priority_min, priority_max]；数据不足 offset+width 字节时视为不满足 */
+typedef enum {
+    EVENT_FILTER_ANY = 0,         /* 不检查数据，只检查优先级 */
+    EVENT_FILTER_EQ,              /* 字段 == value */
+    EVENT_FILTER_NE,              /* 字段 != value */
+    EVENT_FILTER_LT,              /* 字段 <  value */
+    EVENT_FILTER_GE               /* 字段 >= value */
+} Event_FilterOp_t;
+
+typedef struct {
+    uint32_t mask;
+    uint32_t value;
+    uint8_t op;                          /* Event_FilterOp_t */
+    uint8_t offset;                      /* 字段在 data 中的偏移 */
+    uint8_t width;                       /* 字段字节数：1、2 或 4 */
+    uint8_t big_endian;                  /* 1=按大端解析，0=按小端解析 */
+    Event_Priority_t priority_min;
+    Event_Priority_t priority_max;
+} EventFilter_t;
+
+/* EVENT_Process 的处理方式，决定回调中再次发布的事件何时处理、以及分发顺序 */
+typedef enum {
+    EVENT_PROCESS_DEFERRED = 0,   /* 延后：本轮只处理调用时已在队列中的事件（默认） */
+    EVENT_PROCESS_IMMEDIATE,      /* 立即：本轮持续处理，直到队列为空 */
+    EVENT_PROCESS_GROUPED,        /* 分组：同延后模式取一批事件，按类型分组后逐类型连续分发，
+                                     同类型内保持顺序；静态订阅模式下不可用 */
+    EVENT_PROCESS_EDF             /* 截止时间优先：同延后模式取一批事件，按截止时间从早到晚分发，
+                                     同截止时间按优先级从高到低，再按到达顺序；
+                                     没有截止时间的事件排在最后；需 EVENT_DEADLINE_ENABLE */
+} Event_ProcessMode_t;
+
+/* 超出限流速率时的处理方式 */
+typedef enum {
+    EVENT_RATE_DROP = 0,          /* 丢弃，EVENT_Publish 返回 -1 */
+    EVENT_RATE_COALESCE,          /* 合并：只暂存最新一个超额事件，有令牌时再发出，更早的被覆盖 */
+    EVENT_RATE_DEMOTE             /* 降级：照常入队，但优先级改为 demote_priority */
+} Event_RateAction_t;
+
+/* 令牌桶参数：平均每秒 rate 个事件，允许连续突发 burst 个 */
+typedef struct {
+    uint32_t rate;                       /* 每秒令牌数，0 表示取消限流 */
+    uint32_t burst;                      /* 桶容量，至少为 1 */
+    uint8_t action;                      /* Event_RateAction_t */
+    Event_Priority_t demote_priority;    /* 降级后的优先级 */
+} EventRateLimit_t;
+
+typedef struct {
+    uint32_t passed;                     /* 取得令牌正常入队 */
+    uint32_t dropped;
+    uint32_t coalesced;                  /* 被更新的事件覆盖而未发出 */
+    uint32_t demoted;
+} EventRateStats_t;
+
+/* 截止时间统计，仅统计带截止时间的事件 */
+typedef struct {
+    uint32_t dispatched;                 /* 分发完成数 */
+    uint32_t missed;                     /* 分发完成时已超过截止时间 */
+    uint32_t max_late_ms;                /* 最大超时毫秒数 */
+} EventDeadlineStats_t;
+
+/* 去抖/节流方式 */
+typedef enum {
+    EVENT_DEBOUNCE_NONE = 0,      /* 不处理 */
+    EVENT_DEBOUNCE,               /* 去抖：与上一个同类型事件间隔不足 interval 的被丢弃，抖动串只保留第一个 */
+    EVENT_THROTTLE                /* 节流：每个 interval 内只放行第一个 */
+} Event_DebounceMode_t;
+
+/* 事件回调函数类型 */
 typedef void (*EventCallback_t)(Event_t* event, void* arg);
 
-/* ==================== API ==================== */
+/* 时钟函数类型，返回毫秒时间 */
+typedef uint32_t (*EventClock_t)(void* arg);
+
+/* 定时器回调函数类型 */
+typedef void (*EventTimerCallback_t)(void* arg);
+
+/* ==================== 公共API ==================== */
 int EVENT_Init(void);
+/* 每次 EVENT_Init 加一：缓存了"已订阅"状态的上层据此发现订阅表已被清空 */
+uint32_t EVENT_GetInitCount(void);
 
 int EVENT_Subscribe(Event_Type_t type, EventCallback_t callback, void* arg);
 int EVENT_Unsubscribe(Event_Type_t type, EventCallback_t callback, void* arg);
 
+/* 等待分发线程处理完调用时刻之前开始的回调：返回后，此前取消的订阅不会再被调用，
+ * 回调参数指向的对象可以释放；在回调中调用时立即返回（分发线程不会再调用已取消的订阅） */
+void EVENT_Synchronize(void);
+
+/* 带过滤条件的订阅，同样用 EVENT_Unsubscribe 取消 */
+int EVENT_SubscribeFiltered(Event_Type_t type, const EventFilter_t* filter,
+                            EventCallback_t callback, void* arg);
+
+/* 通配订阅：(type & mask) == (value & mask) 的事件都会送达，
+ * 匹配集合由预先生成的位图索引在常数时间内求出 */
+int EVENT_SubscribeMask(Event_Type_t value, Event_Type_t mask,
+                        EventCallback_t callback, void* arg);
+int EVENT_UnsubscribeMask(Event_Type_t value, Event_Type_t mask,
+                          EventCallback_t callback, void* arg);
+
 int EVENT_Publish(Event_Type_t type, Event_Priority_t priority,
                   const void* data, uint8_t data_size);
 
-int EVENT_Process(void);                // رδ¼
+/* 带截止时间发布：deadline_ms 是相对发布时刻的毫秒数，按总线时钟计
+ * 可与任何分发模式配合统计错过截止时间的次数，EVENT_PROCESS_EDF 模式下还按截止时间排序
+ * 未启用 EVENT_DEADLINE_ENABLE 时返回 -1 */
+int EVENT_PublishDeadline(Event_Type_t type, Event_Priority_t priority, uint32_t deadline_ms,
+                          const void* data, uint8_t data_size);
+int EVENT_GetDeadlineStats(EventDeadlineStats_t* stats);   // 未启用截止时间时返回 -1
+
+/* 去抖/节流：在 EVENT_Publish 入队之前按类型丢弃冗余事件，被丢弃时 EVENT_Publish 仍返回 0
+ * 先于限流规则执行；mode 为 EVENT_DEBOUNCE_NONE 时停用 */
+int EVENT_SetDebounce(Event_Type_t type, Event_DebounceMode_t mode, uint32_t interval_ms);
+uint32_t EVENT_GetSuppressed(Event_Type_t type);   // 该类型累计被丢弃的事件数
 
-int EVENT_ClearQueue(void);
+/* 限流：在 EVENT_Publish 中对 (type & mask) == value 的事件执行令牌桶检查，
+ * mask 取 EVENT_TOPIC_MASK_ALL 即按单个类型限流，取 EVENT_TOPIC_MASK_L1/L2 可限制
+ * 某个生产模块发布的整棵主题子树；同一事件只受第一条匹配规则约束
+ * limit 为 NULL 或 rate 为 0 时停用该规则，统计保留 */
+int EVENT_SetRateLimit(Event_Type_t value, Event_Type_t mask, const EventRateLimit_t* limit);
+int EVENT_RateLimitFlush(void);         // 在发布线程中调用，发出已有令牌的合并事件，返回发出数量
+int EVENT_GetRateStats(Event_Type_t value, Event_Type_t mask, EventRateStats_t* stats);
+
+/* 信用流控：(type & mask) == value 的事件组成一个通道，通道有 credits 个信用，
+ * EVENT_Publish 入队前取走一个，EVENT_Process 分发完（或 EVENT_ClearQueue 丢弃）后自动归还；
+ * 没有信用时 EVENT_Publish 返回 -1，事件不入队，生产者可先查询或等待信用，在源头放慢而不是靠丢弃
+ *   int ch = EVENT_SetCredits(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, 16);
+ *   if (EVENT_CreditWait(ch, 10) == 0) EVENT_Publish(EVENT_SENSOR_DATA, ...);
+ * 同一事件只占用第一条匹配通道的信用；信用只在本进程内有效，不适用于跨进程共享队列
+ * 返回通道编号；对已有通道再次设置时按差额调整可用信用，credits 为 0 时停用，
+ * 停用后重新启用应在该通道没有在途事件时进行
+ * EVENT_CreditWait 不睡眠：它反复让出 CPU（sched_yield/SwitchToThread）直到有信用或超时，
+ * 等待期间生产者线程保持可运行状态；消费者长时间跟不上时，超时宜取小值并由调用者决定退避方式 */
+int EVENT_SetCredits(Event_Type_t value, Event_Type_t mask, uint32_t credits);
+int EVENT_GetCredits(int channel);                          // 当前可用信用，通道无效返回 -1
+int EVENT_CreditWait(int channel, uint32_t timeout_ms);     // 在生产者线程中等待到有可用信用，超时返回 -1
+uint32_t EVENT_GetCreditDenied(int channel);                // 因没有信用被拒绝的发布次数
+
+/* 线程模型：队列为单生产者/单消费者无锁环形缓冲，
+ * 一个线程调用 EVENT_Publish，另一个（或同一个）线程调用 EVENT_Process
+ * 回调中可以调用 EVENT_Publish（前提是没有其他线程同时发布），
+ * 正在分发的事件槽位不会被覆盖；回调中嵌套调用 EVENT_Process 直接返回 0 */
+int EVENT_Process(void);                // 返回本次处理的事件数量
+int EVENT_SetProcessMode(Event_ProcessMode_t mode);
+
+/* 时钟：事件时间戳及基于时间的逻辑都从这里取时间
+ * 默认是单调递增的墙上时间（POSIX 的 CLOCK_MONOTONIC，Windows 的 GetTickCount），测试/仿真可换成内置虚拟时钟并手动推进，几小时的流量几秒跑完且结果可复现：
+ *   EVENT_SetClock(EVENT_VirtualClock, NULL);
+ *   EVENT_VirtualClockAdvance(10);
+ * 应在发布线程启动前设置；EVENT_Init 恢复默认时钟，但不清零虚拟时间 */
+int EVENT_SetClock(EventClock_t clock, void* arg);     // clock 为 NULL 时恢复默认
+EventClock_t EVENT_GetClock(void** arg);               // 默认时钟返回 NULL，可原样交给 EVENT_SetClock 恢复
+uint32_t EVENT_GetTime(void);
+uint32_t EVENT_VirtualClock(void* arg);                // 内置虚拟时钟，arg 未使用
+void EVENT_VirtualClockSet(uint32_t ms);
+void EVENT_VirtualClockAdvance(uint32_t ms);
+
+/* 定时器：delay_ms 后在 EVENT_Process 中回调，period_ms 非 0 时按该周期重复
+ * 精度取决于 EVENT_Process 的调用频率；只能在调用 EVENT_Process 的线程中启动/停止
+ * 返回定时器编号，表满返回 -1 */
+int EVENT_TimerStart(uint32_t delay_ms, uint32_t period_ms, EventTimerCallback_t callback, void* arg);
+int EVENT_TimerStop(int id);
+
+int EVENT_ClearQueue(void);             // 丢弃未处理事件，须在消费者线程调用（回调中调用时本轮结束后生效）
 uint16_t EVENT_GetCount(void);
 
 int EVENT_RegisterObserver(EventCallback_t callback, void* arg);
 int EVENT_UnregisterObserver(EventCallback_t callback);
 
+/* 跨进程共享队列（POSIX shm_open/mmap，Windows 下返回 -1）
+ * 打开后本进程的 EVENT_Publish/EVENT_Process 改用段内的队列，订阅表仍是进程私有的；
+ * 每个段只允许一个发布进程和一个处理进程，需要多个进程接收时各建一个段
+ * 本进程首次 EVENT_Publish（或 EVENT_Process）时即确定为发布方（或处理方），此后另一方的操作失败：
+ * 处理进程的回调、定时器中再发布会返回 -1，合并限流的补发也会被丢弃，需要回传时另建一个反向的段
+ * name 形如 "/event_bus"；create 为 1 时创建并初始化段，须先于挂接方调用
+ * 事件时间戳取自发布进程的时钟，跨进程比较没有意义 */
+int EVENT_ShmOpen(const char* name, uint8_t create);
+int EVENT_ShmClose(void);               // 解除映射，恢复使用进程内队列；EVENT_Init 也会自动解除
+int EVENT_ShmUnlink(const char* name);  // 删除段名，已映射的进程不受影响
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __EVENT_H */
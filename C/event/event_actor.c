@@ -0,0 +1,251 @@
+/* event_actor.c
+ * Actor 邮箱与共享事件池
+ */
+
+#include "event_actor.h"
+#include <string.h>
+
+#define ACTOR_CACHE_ALIGNED     __attribute__((aligned(EVENT_CACHE_LINE_SIZE)))
+#define ACTOR_MAILBOX_MASK      (EVENT_ACTOR_MAILBOX_SIZE - 1)
+
+/* ==================== 共享事件池 ==================== */
+/* 每个池项带引用计数，最后一个处理完的 actor 把它放回空闲栈
+ * 空闲栈只有分发线程弹出、多个 actor 线程压入：弹出方唯一，栈顶节点不会被他人取走，没有 ABA 问题 */
+typedef struct PooledEvent {
+    struct PooledEvent* next;           /* 空闲栈链接 */
+    uint32_t refs;
+    Event_t event;
+} PooledEvent_t;
+
+static PooledEvent_t  g_pool[EVENT_ACTOR_POOL_SIZE];
+static PooledEvent_t* g_pool_free = NULL;
+static uint8_t        g_pool_ready = 0;
+
+static void pool_init(void)
+{
+    g_pool_free = NULL;
+    for (int i = EVENT_ACTOR_POOL_SIZE - 1; i >= 0; i--) {
+        g_pool[i].next = g_pool_free;
+        g_pool_free = &g_pool[i];
+    }
+    g_pool_ready = 1;
+}
+
+/* 仅分发线程调用 */
+static PooledEvent_t* pool_alloc(void)
+{
+    PooledEvent_t* head = __atomic_load_n(&g_pool_free, __ATOMIC_ACQUIRE);
+    while (head != NULL &&
+           !__atomic_compare_exchange_n(&g_pool_free, &head, head->next, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    }
+    return head;
+}
+
+/* 任意线程调用 */
+static void pool_release(PooledEvent_t* e)
+{
+    if (__atomic_sub_fetch(&e->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    PooledEvent_t* head = __atomic_load_n(&g_pool_free, __ATOMIC_RELAXED);
+    do {
+        e->next = head;
+    } while (!__atomic_compare_exchange_n(&g_pool_free, &head, e, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* ==================== 邮箱 ==================== */
+/* 与主队列相同的单生产者/单消费者布局：双方索引分居不同缓存行 */
+struct EventActor {
+    ACTOR_CACHE_ALIGNED uint32_t tail;      /* 分发线程写 */
+    uint32_t dropped;
+    ACTOR_CACHE_ALIGNED uint32_t head;      /* actor 线程写 */
+    EventCallback_t callback;
+    void* arg;
+    uint8_t used;
+    PooledEvent_t* slots[EVENT_ACTOR_MAILBOX_SIZE];
+};
+
+static EventActor_t g_actors[EVENT_ACTOR_MAX];
+
+static int mailbox_push(EventActor_t* a, PooledEvent_t* e)
+{
+    uint32_t tail = a->tail;
+    if (tail - __atomic_load_n(&a->head, __ATOMIC_ACQUIRE) >= EVENT_ACTOR_MAILBOX_SIZE) {
+        return -1;
+    }
+    a->slots[tail & ACTOR_MAILBOX_MASK] = e;
+    __atomic_store_n(&a->tail, tail + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* ==================== 路由 ==================== */
+/* 每个被 actor 订阅的类型在总线上只有一个订阅者 actor_fanout，由它把事件分给各 actor */
+typedef struct {
+    uint8_t used;
+    uint8_t count;
+    Event_Type_t type;
+    EventActor_t* actors[EVENT_ACTOR_MAX];
+} ActorRoute_t;
+
+static ActorRoute_t g_routes[EVENT_ACTOR_ROUTE_MAX];
+
+static void actor_fanout(Event_t* event, void* arg)
+{
+    ActorRoute_t* route = (ActorRoute_t*)arg;
+    int n = route->count;
+    if (n == 0) {
+        return;
+    }
+    PooledEvent_t* e = pool_alloc();
+    if (e == NULL) {
+        for (int i = 0; i < n; i++) {
+            __atomic_add_fetch(&route->actors[i]->dropped, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+    memcpy(&e->event, event, EVENT_HEADER_SIZE + event->data_size);
+    __atomic_store_n(&e->refs, (uint32_t)n, __ATOMIC_RELAXED);
+    for (int i = 0; i < n; i++) {
+        if (mailbox_push(route->actors[i], e) != 0) {
+            __atomic_add_fetch(&route->actors[i]->dropped, 1, __ATOMIC_RELAXED);
+            pool_release(e);
+        }
+    }
+}
+
+static ActorRoute_t* route_find(Event_Type_t type)
+{
+    for (int i = 0; i < EVENT_ACTOR_ROUTE_MAX; i++) {
+        if (g_routes[i].used && g_routes[i].type == type) {
+            return &g_routes[i];
+        }
+    }
+    return NULL;
+}
+
+/* ==================== 公共函数实现 ==================== */
+EventActor_t* EVENT_ActorCreate(EventCallback_t callback, void* arg)
+{
+    if (callback == NULL) {
+        return NULL;
+    }
+    if (!g_pool_ready) {
+        pool_init();
+    }
+    for (int i = 0; i < EVENT_ACTOR_MAX; i++) {
+        EventActor_t* a = &g_actors[i];
+        if (!a->used) {
+            memset(a, 0, sizeof(*a));
+            a->callback = callback;
+            a->arg = arg;
+            a->used = 1;
+            return a;
+        }
+    }
+    return NULL;
+}
+
+int EVENT_ActorSubscribe(EventActor_t* actor, Event_Type_t type)
+{
+    if (actor == NULL || !actor->used) {
+        return -1;
+    }
+    ActorRoute_t* route = route_find(type);
+    if (route == NULL) {
+        for (int i = 0; i < EVENT_ACTOR_ROUTE_MAX && route == NULL; i++) {
+            if (!g_routes[i].used) {
+                route = &g_routes[i];
+            }
+        }
+        if (route == NULL) {
+            return -1;
+        }
+        route->count = 0;
+        route->type = type;
+        if (EVENT_Subscribe(type, actor_fanout, route) != 0) {
+            return -1;
+        }
+        route->used = 1;
+    }
+    for (int i = 0; i < route->count; i++) {
+        if (route->actors[i] == actor) {
+            return 0;
+        }
+    }
+    if (route->count >= EVENT_ACTOR_MAX) {
+        return -1;
+    }
+    route->actors[route->count] = actor;
+    route->count++;
+    return 0;
+}
+
+int EVENT_ActorUnsubscribe(EventActor_t* actor, Event_Type_t type)
+{
+    ActorRoute_t* route = route_find(type);
+    if (route == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < route->count; i++) {
+        if (route->actors[i] == actor) {
+            route->actors[i] = route->actors[route->count - 1];
+            route->count--;
+            if (route->count == 0) {
+                EVENT_Unsubscribe(type, actor_fanout, route);
+                route->used = 0;
+            }
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int EVENT_ActorDestroy(EventActor_t* actor)
+{
+    if (actor == NULL || !actor->used) {
+        return -1;
+    }
+    for (int i = 0; i < EVENT_ACTOR_ROUTE_MAX; i++) {
+        if (g_routes[i].used) {
+            EVENT_ActorUnsubscribe(actor, g_routes[i].type);
+        }
+    }
+    /* 邮箱中未处理的事件不再有人处理，归还它们的引用 */
+    uint32_t tail = __atomic_load_n(&actor->tail, __ATOMIC_ACQUIRE);
+    for (uint32_t head = actor->head; head != tail; head++) {
+        pool_release(actor->slots[head & ACTOR_MAILBOX_MASK]);
+    }
+    actor->head = tail;
+    actor->used = 0;
+    return 0;
+}
+
+int EVENT_ActorDrain(EventActor_t* actor, int max)
+{
+    int count = 0;
+    uint32_t head = actor->head;
+    uint32_t tail = __atomic_load_n(&actor->tail, __ATOMIC_ACQUIRE);
+    while (head != tail && (max == 0 || count < max)) {
+        PooledEvent_t* e = actor->slots[head & ACTOR_MAILBOX_MASK];
+        actor->callback(&e->event, actor->arg);
+        pool_release(e);
+        head++;
+        __atomic_store_n(&actor->head, head, __ATOMIC_RELEASE);
+        count++;
+    }
+    return count;
+}
+
+uint16_t EVENT_ActorGetPending(const EventActor_t* actor)
+{
+    uint32_t tail = __atomic_load_n(&actor->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&actor->head, __ATOMIC_ACQUIRE);
+    return (uint16_t)(tail - head);
+}
+
+uint32_t EVENT_ActorGetDropped(const EventActor_t* actor)
+{
+    return __atomic_load_n(&actor->dropped, __ATOMIC_RELAXED);
+}
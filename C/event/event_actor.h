@@ -0,0 +1,64 @@
+/* event_actor.h
+ * Actor 模式：每个 actor 拥有一个有界邮箱，分发线程只把事件的引用放进邮箱，
+ * 由 actor 在自己的线程（或调度时隙）中调用 EVENT_ActorDrain 处理，慢的 actor 不再拖慢其他订阅者
+ *
+ *   EventActor_t* logger = EVENT_ActorCreate(on_log, NULL);
+ *   EVENT_ActorSubscribe(logger, EVENT_SENSOR_DATA);
+ *   // 分发线程：照常 EVENT_Process()
+ *   // logger 线程：while (running) EVENT_ActorDrain(logger, 16);
+ *
+ * - 同一事件只复制一次到引用计数的事件池，所有订阅它的 actor 共享这一份
+ * - 邮箱是单生产者/单消费者无锁环形队列，生产者是分发线程，消费者是该 actor 的线程
+ * - 邮箱满或事件池耗尽时该事件对这个 actor 丢弃并计数，不阻塞分发线程
+ * - Create/Subscribe/Unsubscribe/Destroy 须在分发线程中调用，或在开始处理事件之前调用
+ * - Destroy 前须先停止该 actor 的线程（不再调用 EVENT_ActorDrain），邮箱中剩余的事件被丢弃
+ * 静态订阅模式下不可用
+ */
+
+#ifndef __EVENT_ACTOR_H
+#define __EVENT_ACTOR_H
+
+#include "event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==================== 配置宏 ==================== */
+#ifndef EVENT_ACTOR_MAX
+#define EVENT_ACTOR_MAX             8     // actor 数量
+#endif
+#ifndef EVENT_ACTOR_MAILBOX_SIZE
+#define EVENT_ACTOR_MAILBOX_SIZE    32    // 每个邮箱的深度（必须是 2 的幂）
+#endif
+#ifndef EVENT_ACTOR_POOL_SIZE
+#define EVENT_ACTOR_POOL_SIZE       128   // 共享事件池大小，即同时在途的事件数
+#endif
+#ifndef EVENT_ACTOR_ROUTE_MAX
+#define EVENT_ACTOR_ROUTE_MAX       16    // 被 actor 订阅的事件类型数
+#endif
+
+EVENT_STATIC_ASSERT((EVENT_ACTOR_MAILBOX_SIZE & (EVENT_ACTOR_MAILBOX_SIZE - 1)) == 0,
+                    actor_mailbox_size_must_be_power_of_two);
+
+/* ==================== 类型定义 ==================== */
+typedef struct EventActor EventActor_t;
+
+/* ==================== 公共API ==================== */
+EventActor_t* EVENT_ActorCreate(EventCallback_t callback, void* arg);   // 表满返回 NULL
+int EVENT_ActorDestroy(EventActor_t* actor);    // 取消全部订阅、归还邮箱中的事件，之后槽位可再分配
+
+int EVENT_ActorSubscribe(EventActor_t* actor, Event_Type_t type);
+int EVENT_ActorUnsubscribe(EventActor_t* actor, Event_Type_t type);
+
+/* 在 actor 自己的线程中调用，最多处理 max 个事件（max 为 0 时处理到邮箱为空），返回处理数量 */
+int EVENT_ActorDrain(EventActor_t* actor, int max);
+
+uint16_t EVENT_ActorGetPending(const EventActor_t* actor);     // 邮箱中待处理的事件数
+uint32_t EVENT_ActorGetDropped(const EventActor_t* actor);     // 因邮箱满或事件池耗尽丢弃的事件数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_ACTOR_H */
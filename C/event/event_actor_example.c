@@ -0,0 +1,113 @@
+/* event_actor_example.c
+ * Actor 示例：主线程发布并分发事件，两个 actor 各在自己的线程中处理邮箱；
+ * 慢的 actor 中途被停止并销毁，快的 actor 不受影响
+ * 编译：gcc -std=c99 -pthread event.c event_actor.c event_actor_example.c -o event_actor_example
+ * 仅适用于 POSIX 系统
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#include "event.h"
+#include "event_actor.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define EVENT_SAMPLE    1
+#define SAMPLE_TOTAL    2000
+#define DESTROY_AT      1000    // 发布到第几个事件时销毁慢 actor
+
+typedef struct {
+    EventActor_t* actor;
+    volatile int running;
+    int received;               // 已处理到的序号 + 1
+    int processed;              // 已处理的事件数
+    int out_of_order;
+    int delay_us;               // 每个事件的处理耗时
+} Worker_t;
+
+static void on_sample(Event_t* event, void* arg)
+{
+    Worker_t* w = (Worker_t*)arg;
+    uint32_t seq;
+    memcpy(&seq, event->data, sizeof(seq));
+    if (w->received > 0 && seq < (uint32_t)w->received) {
+        w->out_of_order++;      // 允许因丢弃而跳号，但不能倒序
+    }
+    w->received = (int)seq + 1;
+    w->processed++;
+    if (w->delay_us > 0) {
+        struct timespec ts = {0, w->delay_us * 1000L};
+        nanosleep(&ts, NULL);
+    }
+}
+
+/* actor 线程：反复处理邮箱，空闲时让出 CPU */
+static void* worker_main(void* arg)
+{
+    Worker_t* w = (Worker_t*)arg;
+    while (__atomic_load_n(&w->running, __ATOMIC_ACQUIRE)) {
+        if (EVENT_ActorDrain(w->actor, 16) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    Worker_t fast = {NULL, 1, 0, 0, 0, 0};
+    Worker_t slow = {NULL, 1, 0, 0, 0, 200};
+    pthread_t fast_thread, slow_thread;
+
+    EVENT_Init();
+    fast.actor = EVENT_ActorCreate(on_sample, &fast);
+    slow.actor = EVENT_ActorCreate(on_sample, &slow);
+    EVENT_ActorSubscribe(fast.actor, EVENT_SAMPLE);
+    EVENT_ActorSubscribe(slow.actor, EVENT_SAMPLE);
+    pthread_create(&fast_thread, NULL, worker_main, &fast);
+    pthread_create(&slow_thread, NULL, worker_main, &slow);
+
+    uint32_t slow_lost = 0;     // 慢 actor 被丢弃或销毁时仍在邮箱中的事件
+    int slow_final = 0;
+    int slow_processed = 0;
+    for (uint32_t seq = 0; seq < SAMPLE_TOTAL; seq++) {
+        if (seq == DESTROY_AT) {
+            /* 先停线程，再在分发线程中销毁 */
+            __atomic_store_n(&slow.running, 0, __ATOMIC_RELEASE);
+            pthread_join(slow_thread, NULL);
+            slow_lost = EVENT_ActorGetDropped(slow.actor) + EVENT_ActorGetPending(slow.actor);
+            slow_final = slow.received;
+            slow_processed = slow.processed;
+            EVENT_ActorDestroy(slow.actor);
+        }
+        EVENT_Publish(EVENT_SAMPLE, 0, &seq, sizeof(seq));
+        /* 快 actor 的邮箱留有余量再分发，保证它一个不丢 */
+        while (EVENT_ActorGetPending(fast.actor) > 0) {
+            sched_yield();
+        }
+        EVENT_Process();
+    }
+    while (EVENT_ActorGetPending(fast.actor) > 0) {
+        sched_yield();
+    }
+    __atomic_store_n(&fast.running, 0, __ATOMIC_RELEASE);
+    pthread_join(fast_thread, NULL);
+
+    /* 销毁后的槽位可以再分配 */
+    EventActor_t* again = EVENT_ActorCreate(on_sample, &slow);
+    int reused = (again != NULL && EVENT_ActorDestroy(again) == 0);
+
+    printf("快 actor 收到 %d 个，丢弃 %u 个，倒序 %d 个\n",
+           fast.received, EVENT_ActorGetDropped(fast.actor), fast.out_of_order);
+    printf("慢 actor 销毁前处理 %d 个，丢弃及未处理 %u 个，销毁后不再收到：%s\n",
+           slow_processed, slow_lost, slow.received == slow_final ? "是" : "否");
+    printf("%s\n", (fast.received == SAMPLE_TOTAL && EVENT_ActorGetDropped(fast.actor) == 0 &&
+                    fast.out_of_order == 0 && slow.out_of_order == 0 &&
+                    slow.received == slow_final && slow_processed + (int)slow_lost == DESTROY_AT &&
+                    reused) ? "通过" : "失败");
+
+    EVENT_ActorDestroy(fast.actor);
+    return 0;
+}
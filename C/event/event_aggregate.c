@@ -0,0 +1,204 @@
+/* event_aggregate.c
+ * 窗口聚合
+ */
+
+#include "event_aggregate.h"
+#include <string.h>
+
+/* 聚合状态，仅由分发线程访问 */
+typedef struct {
+    EventAggConfig_t config;
+    uint8_t active;
+    uint8_t started;                    /* 已收到第一个采样，next_end 有效 */
+    uint16_t count;                     /* 缓存的采样数 */
+    uint32_t step;                      /* 相邻窗口终点的间隔 */
+    uint32_t next_end;                  /* 下一个待关闭窗口的终点 */
+    uint32_t dropped;
+    int32_t  values[EVENT_AGG_SAMPLE_MAX];  /* 采样值与时间戳分开存放，归约时只扫 values */
+    uint32_t times[EVENT_AGG_SAMPLE_MAX];
+} Aggregator_t;
+
+static Aggregator_t g_aggs[EVENT_AGG_MAX];
+
+/* 按配置从事件数据区取出采样值，数据不足或无符号值超出 int32_t 时返回 -1 */
+static int sample_decode(const EventAggConfig_t* c, const Event_t* event, int32_t* out)
+{
+    if (c->offset + c->width > event->data_size) {
+        return -1;
+    }
+    const uint8_t* p = event->data + c->offset;
+    uint32_t raw = 0;
+    if (c->big_endian) {
+        for (int i = 0; i < c->width; i++) {
+            raw = (raw << 8) | p[i];
+        }
+    } else {
+        for (int i = c->width - 1; i >= 0; i--) {
+            raw = (raw << 8) | p[i];
+        }
+    }
+    if (!c->is_signed) {
+        if (raw > (uint32_t)INT32_MAX) {
+            return -1;
+        }
+        *out = (int32_t)raw;
+    } else if (c->width == 1) {
+        *out = (int8_t)raw;
+    } else if (c->width == 2) {
+        *out = (int16_t)raw;
+    } else {
+        *out = (int32_t)raw;
+    }
+    return 0;
+}
+
+/* 对连续数组求最小/最大/和，循环体只有条件传送和加法，编译器可以向量化 */
+static void agg_reduce(const int32_t* v, int n, EventAggSummary_t* s)
+{
+    int32_t lo = INT32_MAX;
+    int32_t hi = INT32_MIN;
+    int64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        lo = v[i] < lo ? v[i] : lo;
+        hi = v[i] > hi ? v[i] : hi;
+        sum += v[i];
+    }
+    s->min = lo;
+    s->max = hi;
+    s->mean = (int32_t)(sum / n);
+    s->count = (uint32_t)n;
+}
+
+/* 丢弃时间早于 start 的采样，剩余部分移到数组开头 */
+static void agg_discard_before(Aggregator_t* a, uint32_t start)
+{
+    int keep = 0;
+    while (keep < a->count && (int32_t)(a->times[keep] - start) < 0) {
+        keep++;
+    }
+    if (keep > 0) {
+        a->count -= keep;
+        memmove(a->values, a->values + keep, a->count * sizeof(a->values[0]));
+        memmove(a->times, a->times + keep, a->count * sizeof(a->times[0]));
+    }
+}
+
+/* 包含 t 的窗口中起点最早的那个的终点：窗口起点总是步长的整数倍，
+ * 滑动窗口下 t 同时落在 window_ms/step 个窗口中，首个采样与空档之后都从其中最早的开始，
+ * 因此每个包含采样的窗口都会关闭并发布 */
+static uint32_t agg_window_end(const Aggregator_t* a, uint32_t t)
+{
+    uint32_t base = t - t % a->step;                            /* 起点最晚的那个窗口的起点 */
+    uint32_t back = (base + a->config.window_ms - t - 1) / a->step;
+    if (back > base / a->step) {
+        back = base / a->step;                                  /* 时钟起点附近不产生起点为负的窗口 */
+    }
+    return base - back * a->step + a->config.window_ms;
+}
+
+/* 关闭所有终点不晚于 now 的窗口，返回发布的汇总数
+ * 缓存中的采样都早于 next_end：越过边界的采样总是先触发关闭再入缓存 */
+static int agg_advance(Aggregator_t* a, uint32_t now)
+{
+    int published = 0;
+    while (a->started && (int32_t)(now - a->next_end) >= 0) {
+        uint32_t start = a->next_end - a->config.window_ms;
+        agg_discard_before(a, start);
+        if (a->count == 0) {
+            /* 其后直到 now 的窗口都是空的，直接跳到包含 now 的最早窗口 */
+            a->next_end = agg_window_end(a, now);
+            break;
+        }
+        EventAggSummary_t s;
+        agg_reduce(a->values, a->count, &s);
+        s.start = start;
+        s.end = a->next_end;
+        if (EVENT_Publish(a->config.output, 0, &s, sizeof(s)) == 0) {
+            published++;
+        }
+        a->next_end += a->step;
+    }
+    return published;
+}
+
+static void agg_on_sample(Event_t* event, void* arg)
+{
+    Aggregator_t* a = (Aggregator_t*)arg;
+    int32_t value;
+    if (sample_decode(&a->config, event, &value) != 0) {
+        a->dropped++;
+        return;
+    }
+    uint32_t ts = event->timestamp;
+    if (!a->started) {
+        /* 第一个窗口是包含该采样、起点最早的窗口 */
+        a->next_end = agg_window_end(a, ts);
+        a->started = 1;
+    } else {
+        agg_advance(a, ts);
+    }
+    if (a->count >= EVENT_AGG_SAMPLE_MAX) {
+        a->dropped++;
+        return;
+    }
+    a->values[a->count] = value;
+    a->times[a->count] = ts;
+    a->count++;
+}
+
+int EVENT_AggregateStart(const EventAggConfig_t* config)
+{
+    if (config == NULL || config->window_ms == 0 ||
+        (config->window != EVENT_AGG_TUMBLING && config->window != EVENT_AGG_SLIDING) ||
+        (config->window == EVENT_AGG_SLIDING &&
+         (config->slide_ms == 0 || config->slide_ms > config->window_ms)) ||
+        (config->width != 1 && config->width != 2 && config->width != 4) ||
+        config->offset + config->width > EVENT_DATA_SIZE_MAX) {
+        return -1;
+    }
+    for (int id = 0; id < EVENT_AGG_MAX; id++) {
+        Aggregator_t* a = &g_aggs[id];
+        if (a->active) {
+            continue;
+        }
+        memset(a, 0, sizeof(*a));
+        a->config = *config;
+        a->step = (config->window == EVENT_AGG_SLIDING) ? config->slide_ms : config->window_ms;
+        if (EVENT_Subscribe(config->source, agg_on_sample, a) != 0) {
+            return -1;
+        }
+        a->active = 1;
+        return id;
+    }
+    return -1;
+}
+
+int EVENT_AggregateStop(int id)
+{
+    if (id < 0 || id >= EVENT_AGG_MAX || !g_aggs[id].active) {
+        return -1;
+    }
+    EVENT_Unsubscribe(g_aggs[id].config.source, agg_on_sample, &g_aggs[id]);
+    g_aggs[id].active = 0;
+    return 0;
+}
+
+int EVENT_AggregatePoll(void)
+{
+    int published = 0;
+    uint32_t now = EVENT_GetTime();
+    for (int id = 0; id < EVENT_AGG_MAX; id++) {
+        if (g_aggs[id].active) {
+            published += agg_advance(&g_aggs[id], now);
+        }
+    }
+    return published;
+}
+
+uint32_t EVENT_AggregateGetDropped(int id)
+{
+    if (id < 0 || id >= EVENT_AGG_MAX) {
+        return 0;
+    }
+    return g_aggs[id].dropped;
+}
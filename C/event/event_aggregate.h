@@ -0,0 +1,78 @@
+/* event_aggregate.h
+ * 窗口聚合：订阅某类型的采样事件，按滚动或滑动窗口求最小/最大/平均值，
+ * 每个窗口发布一个汇总事件，下游订阅者只处理汇总
+ *
+ *   EventAggConfig_t cfg = {EVENT_SENSOR_DATA, EVENT_SENSOR_SUMMARY,
+ *                           EVENT_AGG_TUMBLING, 1000, 0,     // 每秒一个窗口
+ *                           0, 2, 0, 1};                     // data[0..1]，无符号，大端
+ *   int id = EVENT_AggregateStart(&cfg);
+ *   // 汇总事件的数据区是 EventAggSummary_t
+ *
+ * 窗口按事件时间戳划分，起点对齐到步长的整数倍（滑动窗口步长为 slide_ms）；
+ * 每个包含采样的窗口都发布一次，包括起点早于首个采样、或落在长时间空档中的滑动窗口；
+ * 采样按到达顺序存放在连续数组中，窗口关闭时对数组整段做归约，循环无分支，编译器可以向量化
+ * 窗口在下一个越过边界的采样到达、或调用 EVENT_AggregatePoll 时关闭，空窗口不发布
+ * 汇总事件在分发线程中发布，须遵守队列的单生产者约定；静态订阅模式下不可用
+ */
+
+#ifndef __EVENT_AGGREGATE_H
+#define __EVENT_AGGREGATE_H
+
+#include "event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==================== 配置宏 ==================== */
+#ifndef EVENT_AGG_MAX
+#define EVENT_AGG_MAX           4     // 同时运行的聚合数量
+#endif
+#ifndef EVENT_AGG_SAMPLE_MAX
+#define EVENT_AGG_SAMPLE_MAX    256   // 每个聚合缓存的采样数，窗口内超出的采样被丢弃并计数
+#endif
+
+/* ==================== 类型定义 ==================== */
+typedef enum {
+    EVENT_AGG_TUMBLING = 0,       /* 滚动窗口：互不重叠，步长等于窗口长度 */
+    EVENT_AGG_SLIDING             /* 滑动窗口：每隔 slide_ms 汇总最近 window_ms 内的采样 */
+} Event_AggWindow_t;
+
+typedef struct {
+    Event_Type_t source;                 /* 采样事件类型 */
+    Event_Type_t output;                 /* 汇总事件类型 */
+    uint8_t window;                      /* Event_AggWindow_t */
+    uint32_t window_ms;
+    uint32_t slide_ms;                   /* 仅滑动窗口使用，须不大于 window_ms */
+    uint8_t offset;                      /* 采样字段在 data 中的偏移 */
+    uint8_t width;                       /* 字段字节数：1、2 或 4 */
+    uint8_t is_signed;                   /* 1=有符号；无符号 4 字节值须小于 2^31，否则丢弃并计数 */
+    uint8_t big_endian;                  /* 1=大端 */
+} EventAggConfig_t;
+
+/* 汇总事件的数据 */
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t mean;                        /* 向零取整 */
+    uint32_t count;                      /* 窗口内采样数 */
+    uint32_t start;                      /* 窗口起止时间（ms），左闭右开 */
+    uint32_t end;
+} EventAggSummary_t;
+
+EVENT_STATIC_ASSERT(sizeof(EventAggSummary_t) <= EVENT_DATA_SIZE_MAX, agg_summary_fits_event);
+
+/* ==================== 公共API ==================== */
+int EVENT_AggregateStart(const EventAggConfig_t* config);   // 返回聚合编号，失败返回 -1
+int EVENT_AggregateStop(int id);
+
+/* 在分发线程中定期调用，按 EVENT_GetTime 关闭已到期的窗口，返回发布的汇总数 */
+int EVENT_AggregatePoll(void);
+
+uint32_t EVENT_AggregateGetDropped(int id);     // 因缓存已满、字段不完整或超出范围而丢弃的采样数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_AGGREGATE_H */
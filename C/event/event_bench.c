@@ -0,0 +1,251 @@
+/* event_bench.c
+ * 双核乒乓基准：生产者线程发布、消费者线程处理，对比两种队列布局
+ *   1) 旧布局：head/tail/count 挤在同一条缓存行，count 由双方共同修改
+ *   2) 新布局：与 event.c 相同，生产者/消费者索引分居不同缓存行，各自缓存对方索引
+ * 两种布局由同一套生产/消费代码驱动，只有入队/出队的索引处理不同，加速比只反映队列布局；
+ * 另外单独测一次完整的 EVENT_Publish/EVENT_Process（含类型查找、订阅表与分发），仅作参考
+ * 编译：gcc -O2 -DEVENT_DEBUG_ENABLE=0 event.c event_bench.c -o event_bench -lpthread
+ * 运行：./event_bench [事件数量]
+ * 线程分别绑定到 0 号和 1 号 CPU（仅 Linux）；单核机器上两个线程共用一个 CPU，
+ * 等待时改为让出 CPU 以免空转整个时间片，此时结果只能说明功能正常，没有性能参考意义
+ */
+
+#define _GNU_SOURCE
+#include "event.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_EVENT_TYPE    1
+#define BENCH_DEFAULT_COUNT 1000000UL
+
+static unsigned long g_total;
+static long g_cpu_count = 1;
+
+/* 等待对方线程：多核上忙等，单核上让出 CPU 给对方 */
+static void bench_wait(void)
+{
+    if (g_cpu_count < 2) {
+        sched_yield();
+    }
+}
+
+/* 获取纳秒级单调时间 */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* 把当前线程绑定到指定 CPU */
+static void pin_to_cpu(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % g_cpu_count, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+static volatile unsigned long g_received;
+
+static void on_bench_event(Event_t* event, void* arg)
+{
+    (void)arg;
+    (void)event;
+    g_received++;
+}
+
+/* ==================== 旧布局队列（对照组） ==================== */
+typedef struct {
+    Event_t queue[EVENT_QUEUE_SIZE];
+    uint16_t head;
+    uint16_t tail;
+    uint16_t count;
+} LegacyQueue_t;
+
+static LegacyQueue_t g_legacy;
+
+static int legacy_push(const Event_t* e)
+{
+    if (__atomic_load_n(&g_legacy.count, __ATOMIC_ACQUIRE) >= EVENT_QUEUE_SIZE) {
+        return -1;
+    }
+    memcpy(&g_legacy.queue[g_legacy.tail], e, sizeof(Event_t));
+    g_legacy.tail = (g_legacy.tail + 1) % EVENT_QUEUE_SIZE;
+    __atomic_add_fetch(&g_legacy.count, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int legacy_pop(Event_t* out)
+{
+    if (__atomic_load_n(&g_legacy.count, __ATOMIC_ACQUIRE) == 0) {
+        return -1;
+    }
+    memcpy(out, &g_legacy.queue[g_legacy.head], sizeof(Event_t));
+    g_legacy.head = (g_legacy.head + 1) % EVENT_QUEUE_SIZE;
+    __atomic_sub_fetch(&g_legacy.count, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* ==================== 新布局队列（与 event.c 相同） ==================== */
+#define BENCH_ALIGNED   __attribute__((aligned(EVENT_CACHE_LINE_SIZE)))
+
+typedef struct {
+    BENCH_ALIGNED uint32_t head;        /* 消费者写 */
+    BENCH_ALIGNED uint32_t tail;        /* 生产者写 */
+    BENCH_ALIGNED uint32_t head_cache;  /* 生产者看到的 head 副本 */
+    BENCH_ALIGNED uint32_t tail_cache;  /* 消费者看到的 tail 副本 */
+    BENCH_ALIGNED Event_t queue[EVENT_QUEUE_SIZE];
+} SplitQueue_t;
+
+static SplitQueue_t g_split;
+
+static int split_push(const Event_t* e)
+{
+    uint32_t tail = g_split.tail;
+    if (tail - g_split.head_cache >= EVENT_QUEUE_SIZE) {
+        g_split.head_cache = __atomic_load_n(&g_split.head, __ATOMIC_ACQUIRE);
+        if (tail - g_split.head_cache >= EVENT_QUEUE_SIZE) {
+            return -1;
+        }
+    }
+    memcpy(&g_split.queue[tail % EVENT_QUEUE_SIZE], e, sizeof(Event_t));
+    __atomic_store_n(&g_split.tail, tail + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int split_pop(Event_t* out)
+{
+    uint32_t head = g_split.head;
+    if (head == g_split.tail_cache) {
+        g_split.tail_cache = __atomic_load_n(&g_split.tail, __ATOMIC_ACQUIRE);
+        if (head == g_split.tail_cache) {
+            return -1;
+        }
+    }
+    memcpy(out, &g_split.queue[head % EVENT_QUEUE_SIZE], sizeof(Event_t));
+    __atomic_store_n(&g_split.head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* ==================== 队列布局对比：共用的生产/消费流程 ==================== */
+/* 与 EVENT_Publish/EVENT_Process 保持一致：发布时清零并填充事件，处理时经函数指针回调 */
+typedef struct {
+    int (*push)(const Event_t* e);
+    int (*pop)(Event_t* out);
+} RingOps_t;
+
+static const RingOps_t g_legacy_ops = { legacy_push, legacy_pop };
+static const RingOps_t g_split_ops = { split_push, split_pop };
+
+static void* ring_producer(void* arg)
+{
+    const RingOps_t* ops = (const RingOps_t*)arg;
+    pin_to_cpu(0);
+    Event_t e;
+    for (unsigned long i = 0; i < g_total; i++) {
+        uint8_t payload = (uint8_t)i;
+        memset(&e, 0, sizeof(e));
+        e.type = BENCH_EVENT_TYPE;
+        e.data_size = 1;
+        memcpy(e.data, &payload, 1);
+        while (ops->push(&e) != 0) {
+            bench_wait();
+        }
+    }
+    return NULL;
+}
+
+static void* ring_consumer(void* arg)
+{
+    const RingOps_t* ops = (const RingOps_t*)arg;
+    EventCallback_t callback = on_bench_event;
+    pin_to_cpu(1);
+    Event_t e;
+    for (unsigned long i = 0; i < g_total; i++) {
+        while (ops->pop(&e) != 0) {
+            bench_wait();
+        }
+        callback(&e, NULL);
+    }
+    return NULL;
+}
+
+/* ==================== 完整总线（EVENT_Publish/EVENT_Process，仅作参考） ==================== */
+static void* bus_producer(void* arg)
+{
+    (void)arg;
+    pin_to_cpu(0);
+    uint8_t payload = 0;
+    for (unsigned long i = 0; i < g_total; i++) {
+        payload = (uint8_t)i;
+        while (EVENT_Publish(BENCH_EVENT_TYPE, 0, &payload, 1) != 0) {
+            bench_wait();
+        }
+    }
+    return NULL;
+}
+
+static void* bus_consumer(void* arg)
+{
+    (void)arg;
+    pin_to_cpu(1);
+    while (g_received < g_total) {
+        if (EVENT_Process() == 0) {
+            bench_wait();
+        }
+    }
+    return NULL;
+}
+
+/* 运行一组生产者/消费者，返回每个事件的平均耗时（ns） */
+static double run_pair(void* (*producer)(void*), void* (*consumer)(void*), void* arg)
+{
+    pthread_t p, c;
+    double start = now_ns();
+    g_received = 0;
+    pthread_create(&c, NULL, consumer, arg);
+    pthread_create(&p, NULL, producer, arg);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    return (now_ns() - start) / (double)g_total;
+}
+
+int main(int argc, char** argv)
+{
+    g_total = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_COUNT;
+    g_cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (g_cpu_count < 1) {
+        g_cpu_count = 1;
+    }
+    if (g_cpu_count < 2) {
+        printf("只有 1 个 CPU：两个线程轮流运行，结果没有性能参考意义\n");
+    }
+
+    printf("事件数量: %lu，队列深度: %d，Event_t 大小: %u 字节\n",
+           g_total, EVENT_QUEUE_SIZE, (unsigned)sizeof(Event_t));
+
+    memset(&g_legacy, 0, sizeof(g_legacy));
+    double legacy = run_pair(ring_producer, ring_consumer, (void*)&g_legacy_ops);
+    printf("旧布局（共享 count）: %.1f ns/事件\n", legacy);
+
+    memset(&g_split, 0, sizeof(g_split));
+    double split = run_pair(ring_producer, ring_consumer, (void*)&g_split_ops);
+    printf("新布局（索引分离）  : %.1f ns/事件\n", split);
+    printf("队列布局加速比: %.2fx\n", legacy / split);
+
+    EVENT_Init();
+    EVENT_Subscribe(BENCH_EVENT_TYPE, on_bench_event, NULL);
+    double bus = run_pair(bus_producer, bus_consumer, NULL);
+    printf("完整总线（含类型查找与分发，仅作参考）: %.1f ns/事件\n", bus);
+    return 0;
+}
@@ -0,0 +1,131 @@
+/* event_bus.hpp
+ * 类型安全的 C++ 前端（C++14，仅头文件），底层仍是 event.c 的队列与订阅表
+ * 事件声明为可平凡复制的结构体，并给出类型 ID：
+ *
+ *   struct SensorSample {
+ *       static constexpr Event_Type_t event_type = "sensor/temp"_topic;
+ *       int16_t celsius_x10;
+ *   };
+ *   using Bus = event::EventBus<SensorSample, ButtonPress>;
+ *
+ *   void on_sample(const SensorSample& s);
+ *   Bus::subscribe<SensorSample, on_sample>();      // 处理函数编译期已知，跳板中直接内联调用
+ *   Bus::subscribe<SensorSample>(logger);           // 任意可调用对象，须在订阅期间保持存活
+ *   Bus::publish(SensorSample{368});                // 大小、可复制性、是否属于本总线均在编译期检查
+ *
+ * 回调中收到的是数据区拷贝出的 T，不必再手工转换 event->data
+ */
+
+#ifndef __EVENT_BUS_HPP
+#define __EVENT_BUS_HPP
+
+#include "event.h"
+#include "event_topic.hpp"
+#include <cstring>
+#include <type_traits>
+
+namespace event {
+
+/* 事件类型 ID，默认取 T::event_type，也可为第三方结构体特化 */
+template <typename T>
+struct event_traits {
+    static constexpr Event_Type_t type = T::event_type;
+};
+
+template <typename T, typename... List>
+struct contains : std::false_type {};
+
+template <typename T, typename Head, typename... Rest>
+struct contains<T, Head, Rest...>
+    : std::integral_constant<bool, std::is_same<T, Head>::value || contains<T, Rest...>::value> {};
+
+/* 从事件数据区还原 T，大小不符时返回 false */
+template <typename T>
+inline bool decode(const Event_t& event, T& out)
+{
+    if (event.data_size != sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&out, event.data, sizeof(T));
+    return true;
+}
+
+template <typename... Events>
+class EventBus {
+public:
+    static_assert(topics_distinct(event_traits<Events>::type...),
+                  "EventBus: 事件类型 ID 重复");
+
+    template <typename T>
+    static int publish(const T& payload, Event_Priority_t priority = 0)
+    {
+        check<T>();
+        return EVENT_Publish(event_traits<T>::type, priority, &payload,
+                             static_cast<uint8_t>(sizeof(T)));
+    }
+
+    /* 静态处理函数：函数地址是模板参数，编译器可把它内联进跳板 */
+    template <typename T, void (*Handler)(const T&)>
+    static int subscribe()
+    {
+        check<T>();
+        return EVENT_Subscribe(event_traits<T>::type, &static_trampoline<T, Handler>, nullptr);
+    }
+
+    template <typename T, void (*Handler)(const T&)>
+    static int unsubscribe()
+    {
+        return EVENT_Unsubscribe(event_traits<T>::type, &static_trampoline<T, Handler>, nullptr);
+    }
+
+    /* 可调用对象：只保存其地址，每种 F 生成一个跳板，operator() 可被内联 */
+    template <typename T, typename F>
+    static int subscribe(F& callable)
+    {
+        check<T>();
+        return EVENT_Subscribe(event_traits<T>::type, &callable_trampoline<T, F>, &callable);
+    }
+
+    template <typename T, typename F>
+    static int unsubscribe(F& callable)
+    {
+        return EVENT_Unsubscribe(event_traits<T>::type, &callable_trampoline<T, F>, &callable);
+    }
+
+    static int process()
+    {
+        return EVENT_Process();
+    }
+
+private:
+    template <typename T>
+    static void check()
+    {
+        static_assert(contains<T, Events...>::value, "EventBus: 该事件类型不属于本总线");
+        static_assert(std::is_trivially_copyable<T>::value, "EventBus: 事件必须可平凡复制");
+        static_assert(sizeof(T) <= EVENT_DATA_SIZE_MAX, "EventBus: 事件超过 EVENT_DATA_SIZE_MAX");
+    }
+
+    template <typename T, void (*Handler)(const T&)>
+    static void static_trampoline(Event_t* event, void* arg)
+    {
+        (void)arg;
+        T value;
+        if (decode(*event, value)) {
+            Handler(value);
+        }
+    }
+
+    template <typename T, typename F>
+    static void callable_trampoline(Event_t* event, void* arg)
+    {
+        T value;
+        if (decode(*event, value)) {
+            (*static_cast<F*>(arg))(value);
+        }
+    }
+};
+
+} // namespace event
+
+#endif /* __EVENT_BUS_HPP */
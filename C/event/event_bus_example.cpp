@@ -0,0 +1,145 @@
+/* event_bus_example.cpp
+ * C++ 前端示例：EventBus 的静态处理函数与可调用对象订阅，Subscription 的内联缓冲区与块池、
+ * 移入只可移动的捕获、块池耗尽，以及在分发过程中（自己的回调里）析构订阅
+ * 编译：gcc -std=c99 -c event.c && g++ -std=c++14 event.o event_bus_example.cpp -o event_bus_example
+ */
+
+#include "event_callable.hpp"
+#include <array>
+#include <cstdio>
+#include <memory>
+
+using namespace event::literals;
+
+struct Temp {
+    static constexpr Event_Type_t event_type = "bus/temp"_topic;
+    int16_t celsius_x10;
+};
+
+struct Button {
+    static constexpr Event_Type_t event_type = "bus/button"_topic;
+    uint8_t id;
+};
+
+using Bus = event::EventBus<Temp, Button>;
+
+static_assert(!std::is_copy_constructible<event::Subscription<>>::value &&
+              !std::is_move_constructible<event::Subscription<>>::value,
+              "Subscription 的地址登记在订阅表中，不可复制也不可移动");
+
+static int g_static_sum = 0;
+
+static void on_temp(const Temp& t)
+{
+    g_static_sum += t.celsius_x10;
+}
+
+/* 析构时计数，用来确认移入 Subscription 的捕获恰好销毁一次 */
+struct Tracker {
+    int* destroyed;
+    ~Tracker()
+    {
+        (*destroyed)++;
+    }
+};
+
+static void drain()
+{
+    while (EVENT_Process() > 0) {
+    }
+}
+
+int main()
+{
+    int pass = 1;
+    EVENT_Init();
+
+    /* 1. EventBus：静态处理函数与可调用对象各收一次；数据大小不符的事件被跳板忽略 */
+    int button_count = 0;
+    auto on_button = [&button_count](const Button& b) { button_count += b.id; };
+    Bus::subscribe<Temp, on_temp>();
+    Bus::subscribe<Button>(on_button);
+    Bus::publish(Temp{368});
+    Bus::publish(Button{2});
+    EVENT_Publish(Temp::event_type, 0, "x", 1);
+    drain();
+    Bus::unsubscribe<Temp, on_temp>();
+    Bus::unsubscribe<Button>(on_button);
+    Bus::publish(Temp{1});
+    Bus::publish(Button{1});
+    drain();
+    printf("EventBus：温度之和 %d，按键之和 %d\n", g_static_sum, button_count);
+    pass &= (g_static_sum == 368 && button_count == 2);
+
+    /* 2. 小捕获放在内联缓冲区，大捕获放进块池，两者都按解码后的值调用 */
+    {
+        int small_sum = 0;
+        std::array<int, 20> table{};          // 80 字节，超过内联缓冲区
+        table[5] = 1000;
+        int large_sum = 0;
+        event::Subscription<> small(Temp::event_type,
+            event::decoded<Temp>([&small_sum](const Temp& t) { small_sum += t.celsius_x10; }));
+        event::Subscription<> large(Temp::event_type,
+            event::decoded<Temp>([table, &large_sum](const Temp& t) { large_sum += table[5] + t.celsius_x10; }));
+        Bus::publish(Temp{7});
+        drain();
+        printf("内联 %d / 块池 %d，小捕获收到 %d，大捕获收到 %d\n",
+               small.is_inline(), !large.is_inline(), small_sum, large_sum);
+        pass &= (small.ok() && large.ok() && small.is_inline() && !large.is_inline() &&
+                 small_sum == 7 && large_sum == 1007);
+    }
+
+    /* 3. 只可移动的捕获移入 Subscription：析构时恰好销毁一次，之后不再收到事件 */
+    int destroyed = 0;
+    int moved_calls = 0;
+    {
+        std::unique_ptr<Tracker> tracker(new Tracker{&destroyed});
+        event::Subscription<> moved(Button::event_type,
+            [t = std::move(tracker), &moved_calls](Event_t&) { moved_calls += (t != nullptr); });
+        Bus::publish(Button{1});
+        drain();
+        pass &= (tracker == nullptr && destroyed == 0);
+    }
+    Bus::publish(Button{1});
+    drain();
+    printf("移入的捕获：调用 %d 次，销毁 %d 次\n", moved_calls, destroyed);
+    pass &= (moved_calls == 1 && destroyed == 1);
+
+    /* 4. 块池耗尽：超出 EVENT_CALLABLE_POOL_COUNT 的大捕获订阅失败，释放后可再用 */
+    {
+        std::array<char, 64> big{};
+        std::unique_ptr<event::Subscription<>> subs[EVENT_CALLABLE_POOL_COUNT + 1];
+        int ok_count = 0;
+        for (int i = 0; i <= EVENT_CALLABLE_POOL_COUNT; i++) {
+            subs[i].reset(new event::Subscription<>(static_cast<Event_Type_t>(300 + i / EVENT_SUBSCRIBER_MAX),
+                                                    [big](Event_t&) { (void)big; }));
+            ok_count += subs[i]->ok();
+        }
+        bool last_failed = !subs[EVENT_CALLABLE_POOL_COUNT]->ok();
+        subs[0].reset();
+        event::Subscription<> again(static_cast<Event_Type_t>(300), [big](Event_t&) { (void)big; });
+        printf("块池 %d 块：成功 %d 个，最后一个失败：%s，释放一块后再订阅：%s\n",
+               EVENT_CALLABLE_POOL_COUNT, ok_count, last_failed ? "是" : "否", again.ok() ? "成功" : "失败");
+        pass &= (ok_count == EVENT_CALLABLE_POOL_COUNT && last_failed && again.ok());
+    }
+
+    /* 5. 分发中取消订阅：同一批 3 个事件，订阅在自己的第一次回调里析构，之后不再被调用，
+     *    另一个订阅者照常收到全部 3 个 */
+    int self_calls = 0;
+    int other_calls = 0;
+    std::unique_ptr<event::Subscription<>> self;
+    event::Subscription<> other(Button::event_type, [&other_calls](Event_t&) { other_calls++; });
+    self.reset(new event::Subscription<>(Button::event_type, [&self, &self_calls](Event_t&) {
+        self_calls++;
+        self.reset();                       // 销毁本对象，之后不能再访问捕获
+    }));
+    for (uint8_t i = 0; i < 3; i++) {
+        Bus::publish(Button{i});
+    }
+    drain();
+    printf("分发中析构：自身调用 %d 次，其他订阅者收到 %d 个\n", self_calls, other_calls);
+    pass &= (self == nullptr && self_calls == 1 && other_calls == 3);
+
+    printf("%s\n", pass ? "通过" : "失败");
+    return 0;
+}
@@ -0,0 +1,212 @@
+/* event_callable.hpp
+ * 可携带状态的 C++ 订阅者（C++14，仅头文件）
+ * lambda/函数对象直接存放在 Subscription 内部的定长缓冲区中，放不下时改用静态块池，
+ * 订阅时不分配堆内存；分发时 C 层回调就是按 F 生成的跳板，arg 直接指向对象本身，
+ * 不需要额外的上下文对象和手写跳板
+ *
+ *   int threshold = 300;
+ *   event::Subscription<> sub(EVENT_SENSOR_DATA, [threshold](Event_t& e) { ... });
+ *   event::Subscription<> typed(Temp::event_type,
+ *                               event::decoded<Temp>([&](const Temp& t) { ... }));
+ *   // sub 析构时自动取消订阅
+ *
+ * Subscription 的地址登记在订阅表中，因此不可复制、不可移动
+ * 析构时先取消订阅，再用 EVENT_Synchronize 等分发线程离开可能正在执行的这个回调，
+ * 然后才销毁可调用对象；可以在任意线程（包括在自己的回调中）析构，
+ * 但须在总线重新 EVENT_Init 之前析构，否则取消订阅失败会触发断言
+ */
+
+#ifndef __EVENT_CALLABLE_HPP
+#define __EVENT_CALLABLE_HPP
+
+#include "event.h"
+#include "event_bus.hpp"
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef EVENT_CALLABLE_INLINE_SIZE
+#define EVENT_CALLABLE_INLINE_SIZE  32    // Subscription 内联缓冲区字节数
+#endif
+#ifndef EVENT_CALLABLE_POOL_BLOCK
+#define EVENT_CALLABLE_POOL_BLOCK   128   // 溢出池每块字节数
+#endif
+#ifndef EVENT_CALLABLE_POOL_COUNT
+#define EVENT_CALLABLE_POOL_COUNT   16    // 溢出池块数
+#endif
+
+namespace event {
+
+/* 定长块池：静态存储 + 空闲链，用自旋锁保护，仅在订阅/取消订阅时使用 */
+template <std::size_t BlockSize, std::size_t BlockCount>
+class BlockPool {
+public:
+    static void* alloc()
+    {
+        State& s = state();
+        lock(s);
+        Block* b = s.free;
+        if (b != nullptr) {
+            s.free = b->next;
+        }
+        unlock(s);
+        return b;
+    }
+
+    static void free(void* p)
+    {
+        if (p == nullptr) {
+            return;
+        }
+        State& s = state();
+        lock(s);
+        Block* b = static_cast<Block*>(p);
+        b->next = s.free;
+        s.free = b;
+        unlock(s);
+    }
+
+private:
+    union Block {
+        Block* next;
+        alignas(std::max_align_t) unsigned char bytes[BlockSize];
+    };
+
+    struct State {
+        Block blocks[BlockCount];
+        Block* free;
+        unsigned char lock;
+
+        State() : free(nullptr), lock(0)
+        {
+            for (std::size_t i = BlockCount; i > 0; i--) {
+                blocks[i - 1].next = free;
+                free = &blocks[i - 1];
+            }
+        }
+    };
+
+    static State& state()
+    {
+        static State s;
+        return s;
+    }
+
+    static void lock(State& s)
+    {
+        while (__atomic_test_and_set(&s.lock, __ATOMIC_ACQUIRE)) {
+        }
+    }
+
+    static void unlock(State& s)
+    {
+        __atomic_clear(&s.lock, __ATOMIC_RELEASE);
+    }
+};
+
+using CallablePool = BlockPool<EVENT_CALLABLE_POOL_BLOCK, EVENT_CALLABLE_POOL_COUNT>;
+
+template <std::size_t InlineSize = EVENT_CALLABLE_INLINE_SIZE>
+class Subscription {
+public:
+    /* F 须可以 f(Event_t&) 方式调用；失败（块池耗尽或订阅表已满）时 ok() 返回 false */
+    template <typename F>
+    Subscription(Event_Type_t type, F&& f)
+        : target_(nullptr), destroy_(nullptr), invoke_(nullptr), type_(type), subscribed_(false)
+    {
+        using Fn = typename std::decay<F>::type;
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Subscription: 对齐要求过高");
+        static_assert(sizeof(Fn) <= InlineSize || sizeof(Fn) <= EVENT_CALLABLE_POOL_BLOCK,
+                      "Subscription: 可调用对象超过块池的块大小");
+
+        void* storage = (sizeof(Fn) <= InlineSize) ? static_cast<void*>(buffer_) : CallablePool::alloc();
+        if (storage == nullptr) {
+            return;
+        }
+        target_ = new (storage) Fn(std::forward<F>(f));
+        destroy_ = &destroy<Fn>;
+        invoke_ = &invoke<Fn>;
+        subscribed_ = (EVENT_Subscribe(type_, invoke_, target_) == 0);
+    }
+
+    ~Subscription()
+    {
+        if (subscribed_) {
+            int ret = EVENT_Unsubscribe(type_, invoke_, target_);
+            assert(ret == 0 && "Subscription: 订阅项已不在订阅表中");
+            (void)ret;
+            EVENT_Synchronize();
+        }
+        if (target_ != nullptr) {
+            destroy_(target_);
+            if (target_ != static_cast<void*>(buffer_)) {
+                CallablePool::free(target_);
+            }
+        }
+    }
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    bool ok() const
+    {
+        return subscribed_;
+    }
+
+    /* 对象是否放在内联缓冲区中 */
+    bool is_inline() const
+    {
+        return target_ == static_cast<const void*>(buffer_);
+    }
+
+private:
+    template <typename Fn>
+    static void invoke(Event_t* event, void* arg)
+    {
+        (*static_cast<Fn*>(arg))(*event);
+    }
+
+    template <typename Fn>
+    static void destroy(void* p)
+    {
+        static_cast<Fn*>(p)->~Fn();
+    }
+
+    alignas(std::max_align_t) unsigned char buffer_[InlineSize];
+    void* target_;
+    void (*destroy_)(void*);
+    EventCallback_t invoke_;
+    Event_Type_t type_;
+    bool subscribed_;
+};
+
+/* 把处理 const T& 的可调用对象包装成处理 Event_t& 的对象，数据大小不符的事件被忽略 */
+template <typename T, typename F>
+class Decoded {
+public:
+    explicit Decoded(F f) : f_(std::move(f)) {}
+
+    void operator()(Event_t& event)
+    {
+        T value;
+        if (decode(event, value)) {
+            f_(value);
+        }
+    }
+
+private:
+    F f_;
+};
+
+template <typename T, typename F>
+inline Decoded<T, typename std::decay<F>::type> decoded(F&& f)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "decoded: 事件必须可平凡复制");
+    return Decoded<T, typename std::decay<F>::type>(std::forward<F>(f));
+}
+
+} // namespace event
+
+#endif /* __EVENT_CALLABLE_HPP */
@@ -0,0 +1,215 @@
+/* event_coro.hpp
+ * 协程前端（C++20，仅头文件）：用顺序代码写多步协议，不必拆成一串回调
+ *
+ *   using Bus = event::CoEventBus<Request, Ack>;
+ *
+ *   event::Task handshake(Bus& bus)
+ *   {
+ *       auto req = co_await bus.next<Request>();      // 挂起，直到分发线程分发下一个 Request
+ *       if (!req) co_return;                           // 订阅失败或总线被重新初始化
+ *       Bus::publish(Ack{req->id});
+ *       auto ack = co_await bus.next<Ack>();
+ *       ...
+ *   }
+ *
+ *   Bus bus;
+ *   handshake(bus);            // 立即运行到第一个 co_await
+ *   while (...) EVENT_Process();
+ *
+ * - 协程在分发线程中恢复运行，一个线程即可承载成千上万个轻量流程
+ * - 同一类型的所有等待者共用一个底层订阅：有等待者时订阅，事件到达后一次唤醒全部等待者，
+ *   唤醒后仍无人等待才取消订阅，稳态下循环等待同一类型不会反复订阅
+ * - co_await 的结果是 std::optional<T>，为空表示等不到了：底层订阅失败时不挂起、立即返回空；
+ *   EVENT_Init 清空订阅表后，下一次等待该类型时先以空值唤醒之前的等待者，再重新订阅
+ * - 协程帧从静态块池分配，不使用堆；帧超过块大小或块池耗尽时协程不会启动，Task::ok() 返回 false
+ * - 协程结束时帧自动释放，Task 只用于检查是否启动成功
+ */
+
+#ifndef __EVENT_CORO_HPP
+#define __EVENT_CORO_HPP
+
+#include "event.h"
+#include "event_bus.hpp"
+#include "event_callable.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+#ifndef EVENT_CORO_FRAME_SIZE
+#define EVENT_CORO_FRAME_SIZE   256     // 协程帧块字节数
+#endif
+#ifndef EVENT_CORO_FRAME_COUNT
+#define EVENT_CORO_FRAME_COUNT  1024    // 协程帧块数，即可同时存在的协程数
+#endif
+
+namespace event {
+
+using FramePool = BlockPool<EVENT_CORO_FRAME_SIZE, EVENT_CORO_FRAME_COUNT>;
+
+/* 分离运行的协程：创建后立即执行，结束时自行销毁帧 */
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() noexcept
+        {
+            return Task(true);
+        }
+
+        static Task get_return_object_on_allocation_failure() noexcept
+        {
+            return Task(false);
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+
+        static void* operator new(std::size_t size) noexcept
+        {
+            return size <= EVENT_CORO_FRAME_SIZE ? FramePool::alloc() : nullptr;
+        }
+
+        static void operator delete(void* p) noexcept
+        {
+            FramePool::free(p);
+        }
+    };
+
+    bool ok() const
+    {
+        return started_;
+    }
+
+private:
+    explicit Task(bool started) : started_(started) {}
+
+    bool started_;
+};
+
+template <typename T>
+class Waiters;
+
+/* co_await next<T>() 的等待体，存放在协程帧中，挂起期间地址不变 */
+template <typename T>
+class NextAwaiter {
+public:
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /* 订阅失败时返回 false，协程不挂起，await_resume 得到空值 */
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        handle_ = handle;
+        return Waiters<T>::push(this);
+    }
+
+    std::optional<T> await_resume() const noexcept
+    {
+        return value_;
+    }
+
+private:
+    friend class Waiters<T>;
+
+    NextAwaiter* next_ = nullptr;
+    std::coroutine_handle<> handle_;
+    std::optional<T> value_;
+};
+
+/* 类型 T 的等待队列（先进先出）与对应的底层订阅，只在分发线程中访问 */
+template <typename T>
+class Waiters {
+public:
+    /* 订阅失败时不入队并返回 false */
+    static bool push(NextAwaiter<T>* awaiter)
+    {
+        if (subscribed_ && init_count_ != EVENT_GetInitCount()) {
+            /* 总线已重新初始化，旧订阅不复存在，原来的等待者再也等不到事件 */
+            subscribed_ = false;
+            resume_all(std::nullopt);
+        }
+        if (!subscribed_) {
+            if (EVENT_Subscribe(event_traits<T>::type, &on_event, nullptr) != 0) {
+                return false;
+            }
+            subscribed_ = true;
+            init_count_ = EVENT_GetInitCount();
+        }
+        awaiter->next_ = nullptr;
+        if (tail_ != nullptr) {
+            tail_->next_ = awaiter;
+        } else {
+            head_ = awaiter;
+        }
+        tail_ = awaiter;
+        return true;
+    }
+
+private:
+    /* 先摘下整条队列：被唤醒的协程再次等待时进入新队列，等下一个事件 */
+    static void resume_all(const std::optional<T>& value)
+    {
+        NextAwaiter<T>* awaiter = head_;
+        head_ = tail_ = nullptr;
+        while (awaiter != nullptr) {
+            NextAwaiter<T>* next = awaiter->next_;  // 恢复后协程可能结束，帧随之释放
+            awaiter->value_ = value;
+            awaiter->handle_.resume();
+            awaiter = next;
+        }
+    }
+
+    static void on_event(Event_t* event, void* arg)
+    {
+        (void)arg;
+        T value;
+        if (!decode(*event, value)) {
+            return;
+        }
+        resume_all(value);
+        if (head_ == nullptr && subscribed_) {
+            EVENT_Unsubscribe(event_traits<T>::type, &on_event, nullptr);
+            subscribed_ = false;
+        }
+    }
+
+    static inline NextAwaiter<T>* head_ = nullptr;
+    static inline NextAwaiter<T>* tail_ = nullptr;
+    static inline bool subscribed_ = false;
+    static inline uint32_t init_count_ = 0;     // 订阅时的 EVENT_GetInitCount()
+};
+
+/* 在 EventBus 之上增加 next<T>()，其余接口不变 */
+template <typename... Events>
+class CoEventBus : public EventBus<Events...> {
+public:
+    template <typename T>
+    static NextAwaiter<T> next()
+    {
+        static_assert(contains<T, Events...>::value, "CoEventBus: 该事件类型不属于本总线");
+        static_assert(std::is_trivially_copyable<T>::value, "CoEventBus: 事件必须可平凡复制");
+        return NextAwaiter<T>();
+    }
+};
+
+} // namespace event
+
+#endif /* __EVENT_CORO_HPP */
@@ -0,0 +1,85 @@
+/* event_coro_example.cpp
+ * 协程前端示例：顺序等待事件、订阅失败时不挂起、总线重新初始化后唤醒旧的等待者
+ * 编译：gcc -std=c99 -c event.c && g++ -std=c++20 event.o event_coro_example.cpp -o event_coro_example
+ */
+
+#include "event_coro.hpp"
+#include <cstdio>
+
+using namespace event::literals;
+
+struct Request {
+    static constexpr Event_Type_t event_type = "coro/request"_topic;
+    int id;
+};
+
+struct Ack {
+    static constexpr Event_Type_t event_type = "coro/ack"_topic;
+    int id;
+};
+
+using Bus = event::CoEventBus<Request, Ack>;
+
+static int g_acked = 0;        // 收到应答的请求号之和
+static int g_empty = 0;        // 等待得到空值的次数
+
+/* 两步协议：等请求、回应答、再等应答 */
+static event::Task handshake(Bus& bus)
+{
+    auto req = co_await bus.next<Request>();
+    if (!req) {
+        g_empty++;
+        co_return;
+    }
+    Bus::publish(Ack{req->id});
+    auto ack = co_await bus.next<Ack>();
+    if (!ack) {
+        g_empty++;
+        co_return;
+    }
+    g_acked += ack->id;
+}
+
+static void on_request(Event_t* event, void* arg)
+{
+    (void)event;
+    (void)arg;
+}
+
+int main()
+{
+    Bus bus;
+    int pass = 1;
+    EVENT_Init();
+
+    /* 1. 正常流程：两个协程共用一个底层订阅，各自完成握手 */
+    handshake(bus);
+    handshake(bus);
+    Bus::publish(Request{7});
+    while (EVENT_Process() > 0) {
+    }
+    printf("握手完成，应答号之和 %d\n", g_acked);
+    pass &= (g_acked == 14 && g_empty == 0);
+
+    /* 2. Request 的订阅表已满：协程不挂起，立即得到空值 */
+    for (int i = 0; i < EVENT_SUBSCRIBER_MAX; i++) {
+        EVENT_Subscribe(Request::event_type, on_request, reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+    }
+    handshake(bus);
+    printf("订阅失败时得到空值 %d 次\n", g_empty);
+    pass &= (g_empty == 1);
+
+    /* 3. 重新初始化：旧的等待者在下一次等待时以空值唤醒，新的等待者重新订阅 */
+    EVENT_Init();
+    handshake(bus);             // 订阅 Request 并挂起
+    EVENT_Init();               // 订阅表被清空，上面的协程再也等不到 Request
+    handshake(bus);             // 唤醒旧的等待者，自己重新订阅
+    Bus::publish(Request{5});
+    while (EVENT_Process() > 0) {
+    }
+    printf("重新初始化后空值共 %d 次，应答号之和 %d\n", g_empty, g_acked);
+    pass &= (g_empty == 2 && g_acked == 19);
+
+    printf("%s\n", pass ? "通过" : "失败");
+    return 0;
+}
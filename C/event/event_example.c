@@ -1,124 +1,752 @@
 /* event_example.c
- * ǿ棺кʾÿһʲô
- * 룺gcc event.c event_example.c -o event_test
- * кῴɫWindows cmd ֲ֧ɫ
+ * 加强反馈版：运行后会清晰显示每一步发生了什么
+ * 编译：gcc event.c event_request.c event_aggregate.c event_pipeline.c event_actor.c event_example.c -o event_test
+ * 运行后会看到大量彩色输出（Windows cmd 支持部分颜色）
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L     /* nanosleep */
+#endif
+
 #include "event.h"
+#include "event_request.h"
+#include "event_aggregate.h"
+#include "event_pipeline.h"
+#include "event_actor.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 真实睡眠，用于验证默认时钟下基于时间的功能
+static void sleep_ms(unsigned ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
 
-// һЩ¼
+// 定义一些事件类型
 typedef enum {
-    EVENT_BUTTON_PRESS = 1,   // ť
-    EVENT_SENSOR_DATA,        // ݵ
-    EVENT_SYSTEM_ALERT,       // ϵͳ
-    EVENT_USER_LOGIN          // û¼
+    EVENT_BUTTON_PRESS = 1,   // 按钮按下
+    EVENT_SENSOR_DATA,        // 传感器数据到达
+    EVENT_SYSTEM_ALERT,       // 系统警报
+    EVENT_USER_LOGIN,         // 用户登录
+    EVENT_CHAIN_STEP,         // 链式事件（回调中再次发布）
+    EVENT_CONTROL_CMD,        // 带截止时间的控制命令
+    EVENT_QUERY_TEMP,         // 请求/应答：查询温度
+    EVENT_CHURN_TEST,         // 回调中反复订阅/取消订阅
+    EVENT_AGG_SAMPLE,         // 窗口聚合：采样
+    EVENT_AGG_SUMMARY,        // 窗口聚合：汇总
+    EVENT_PIPE_RAW,           // 流水线：原始读数
+    EVENT_PIPE_SMOOTHED,      // 流水线：平滑后的读数（中间类型）
+    EVENT_PIPE_ALARM,         // 流水线：超限报警
+    EVENT_FILTER_TEST,        // 过滤订阅
+    EVENT_GROUP_A,            // 分组分发：类型 A
+    EVENT_GROUP_B,            // 分组分发：类型 B
+    EVENT_GROUP_C,            // 分组分发：没有订阅者的类型
+    EVENT_ACTOR_TEST          // actor 邮箱
 } MyEventType;
 
-// ȼ
+// 优先级定义
 #define PRIORITY_LOW     0
 #define PRIORITY_NORMAL  1
 #define PRIORITY_HIGH    2
 
-// ص1ť¼
+// 回调1：处理按钮按下事件
 void on_button_press(Event_t* event, void* arg)
 {
     const char* button_name = (const char*)arg;
-    printf("\033[1;33m[ص] ť¼...\033[0m\n");
-    printf("    ť: %s\n", button_name);
-    printf("    ʱ: %u ms\n", event->timestamp);
-    printf("    ȼ: %d\n\n", event->priority);
+    printf("\033[1;33m[回调触发] 按钮事件处理中...\033[0m\n");
+    printf("   → 按钮名称: %s\n", button_name);
+    printf("   → 时间戳: %u ms\n", event->timestamp);
+    printf("   → 优先级: %d\n\n", event->priority);
 }
 
-// ص2
+// 回调2：处理传感器数据
 void on_sensor_data(Event_t* event, void* arg)
 {
-    (void)arg;  // δʹ
-    printf("\033[1;32m[ص] ѵ\033[0m\n");
+    (void)arg;  // 未使用
+    printf("\033[1;32m[回调触发] 传感器数据已到达！\033[0m\n");
     if (event->data_size > 0) {
-        printf("    ݳ: %d ֽ\n", event->data_size);
-        printf("    : ");
+        printf("   → 数据长度: %d 字节\n", event->data_size);
+        printf("   → 数据内容: ");
         for (uint8_t i = 0; i < event->data_size; i++) {
             printf("%02X ", event->data[i]);
         }
         printf("\n");
-        // ¶ݣʾ
+        // 假设是温度数据（示例）
         if (event->data_size >= 2) {
             int temp = (event->data[0] << 8) | event->data[1];
-            printf("    ¶: %.1f C\n", temp / 10.0);
+            printf("   → 解析温度: %.1f °C\n", temp / 10.0);
         }
     }
     printf("\n");
 }
 
-// ص3ϵͳ
+// 回调3：处理系统警报
 void on_system_alert(Event_t* event, void* arg)
 {
     int* alert_level = (int*)arg;
-    printf("\033[1;31m[ص] ϵͳ\033[0m\n");
-    printf("    : %d\n", *alert_level);
-    printf("    ¼ʱ: %u ms\n\n", event->timestamp);
+    printf("\033[1;31m[紧急回调] 系统警报触发！\033[0m\n");
+    printf("   → 警报级别: %d\n", *alert_level);
+    printf("   → 事件时间: %u ms\n\n", event->timestamp);
 }
 
-// ȫֹ۲ߣ¼Եķ
+// 全局观察者：监控所有事件（最明显的反馈）
 void global_observer(Event_t* event, void* arg)
 {
     (void)arg;
     static const char* type_names[] = {
-        "δ֪", "ť", "", "ϵͳ", "û¼"
+        "未知", "按钮按下", "传感器数据", "系统警报", "用户登录"
     };
-    const char* type_name = (event->type < 5) ? type_names[event->type] : "¼";
+    const char* type_name = (event->type < 5) ? type_names[event->type] : "其他事件";
 
-    printf("\033[1;36m=== ȫֹ۲߲¼ ===\033[0m\n");
-    printf("   ID: %u  %s\n", event->type, type_name);
-    printf("   ȼ: %d\n", event->priority);
-    printf("   ʱ: %u ms\n", event->timestamp);
-    printf("   ݴС: %d ֽ\n", event->data_size);
+    printf("\033[1;36m=== 全局观察者捕获事件 ===\033[0m\n");
+    printf("   类型ID: %u → %s\n", event->type, type_name);
+    printf("   优先级: %d\n", event->priority);
+    printf("   时间戳: %u ms\n", event->timestamp);
+    printf("   数据大小: %d 字节\n", event->data_size);
     printf("\033[1;36m==========================\033[0m\n\n");
 }
 
+// 回调4：链式事件，每处理一个就在回调中再发布下一个
+#define CHAIN_INITIAL   40    // 预先放入队列的事件数
+#define CHAIN_TOTAL     100   // 总事件数，超过队列深度，保证环形队列回绕
+static uint8_t chain_next;    // 下一个要发布的序号
+static uint8_t chain_expect;  // 下一个应收到的序号
+static int chain_errors;
+
+void on_chain_step(Event_t* event, void* arg)
+{
+    (void)arg;
+    if (event->data[0] != chain_expect) {
+        chain_errors++;       // 顺序错乱或槽位被覆盖
+    }
+    chain_expect++;
+    if (chain_next < CHAIN_TOTAL) {
+        EVENT_Publish(EVENT_CHAIN_STEP, PRIORITY_LOW, &chain_next, 1);
+        chain_next++;
+    }
+}
+
+// 嵌套发布演示：回调中发布的事件在队列回绕后依然按序到达
+void demo_nested_publish(Event_ProcessMode_t mode, const char* mode_name)
+{
+    printf("\033[1;35m→ 嵌套发布演示（%s模式）\033[0m\n", mode_name);
+    EVENT_SetProcessMode(mode);
+    chain_next = 0;
+    chain_expect = 0;
+    chain_errors = 0;
+    while (chain_next < CHAIN_INITIAL) {
+        EVENT_Publish(EVENT_CHAIN_STEP, PRIORITY_LOW, &chain_next, 1);
+        chain_next++;
+    }
+    int pass = 0;
+    int processed;
+    while ((processed = EVENT_Process()) > 0) {
+        printf("   → 第 %d 轮处理 %d 个事件\n", ++pass, processed);
+    }
+    printf("   → 共收到 %u 个事件，顺序错误 %d 个：%s\n\n", chain_expect, chain_errors,
+           (chain_expect == CHAIN_TOTAL && chain_errors == 0) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+}
+
+// 虚拟时钟：时间戳完全由程序推进，结果可复现
+void demo_virtual_clock(void)
+{
+    printf("\n\033[1;35m→ 虚拟时钟：每发布一个事件推进 250 ms\033[0m\n");
+    EVENT_SetClock(EVENT_VirtualClock, NULL);
+    EVENT_VirtualClockSet(1000);
+    for (int i = 0; i < 3; i++) {
+        EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_LOW, NULL, 0);
+        EVENT_VirtualClockAdvance(250);
+    }
+    EVENT_Process();    // 时间戳依次为 1000、1250、1500 ms
+    EVENT_SetClock(NULL, NULL);
+}
+
+// 去抖：按键抖动产生的一串事件在入队前就被合并为一次
+void demo_debounce(void)
+{
+    printf("\n\033[1;35m→ 去抖：按键在 8 ms 内抖动 5 次，100 ms 后再按一次\033[0m\n");
+    EVENT_SetClock(EVENT_VirtualClock, NULL);
+    EVENT_SetDebounce(EVENT_BUTTON_PRESS, EVENT_DEBOUNCE, 20);
+    for (int i = 0; i < 5; i++) {
+        EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_NORMAL, NULL, 0);
+        EVENT_VirtualClockAdvance(2);
+    }
+    EVENT_VirtualClockAdvance(100);
+    EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_NORMAL, NULL, 0);
+    printf("   → 入队 %u 个，丢弃 %u 个：%s\n", EVENT_GetCount(), EVENT_GetSuppressed(EVENT_BUTTON_PRESS),
+           (EVENT_GetCount() == 2 && EVENT_GetSuppressed(EVENT_BUTTON_PRESS) == 4) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Process();
+    EVENT_SetDebounce(EVENT_BUTTON_PRESS, EVENT_DEBOUNCE_NONE, 0);
+    EVENT_SetClock(NULL, NULL);
+
+    printf("\n\033[1;35m→ 去抖（真实时钟）：按一次，睡眠 200 ms 后再按一次并立即抖动一次\033[0m\n");
+    EVENT_SetDebounce(EVENT_BUTTON_PRESS, EVENT_DEBOUNCE, 20);
+    uint32_t suppressed = EVENT_GetSuppressed(EVENT_BUTTON_PRESS);
+    EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_NORMAL, NULL, 0);
+    sleep_ms(200);
+    EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_NORMAL, NULL, 0);
+    EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_NORMAL, NULL, 0);   // 抖动
+    suppressed = EVENT_GetSuppressed(EVENT_BUTTON_PRESS) - suppressed;
+    printf("   → 入队 %u 个，丢弃 %u 个：%s\n", EVENT_GetCount(), suppressed,
+           (EVENT_GetCount() == 2 && suppressed == 1) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Process();
+    EVENT_SetDebounce(EVENT_BUTTON_PRESS, EVENT_DEBOUNCE_NONE, 0);
+}
+
+// 限流：同样每秒 10 个、突发 2 个的令牌桶，超额时丢弃与合并的区别
+void demo_rate_limit(void)
+{
+    printf("\n\033[1;35m→ 限流：每秒 10 个、突发 2 个；传感器超额丢弃，登录超额合并，各连发 5 个\033[0m\n");
+    EventRateLimit_t drop = { 10, 2, EVENT_RATE_DROP, 0 };
+    EventRateLimit_t coalesce = { 10, 2, EVENT_RATE_COALESCE, 0 };
+    EVENT_SetRateLimit(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, &drop);
+    EVENT_SetRateLimit(EVENT_USER_LOGIN, EVENT_TOPIC_MASK_ALL, &coalesce);
+    for (uint8_t i = 0; i < 5; i++) {
+        EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, &i, 1);
+        EVENT_Publish(EVENT_USER_LOGIN, PRIORITY_NORMAL, "u", 2);
+    }
+    EVENT_Process();
+    sleep_ms(150);                  // 补充 1.5 个令牌
+    int flushed = EVENT_RateLimitFlush();   // 发出合并后留下的最新一个
+    EVENT_Process();
+
+    EventRateStats_t d, c;
+    EVENT_GetRateStats(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, &d);
+    EVENT_GetRateStats(EVENT_USER_LOGIN, EVENT_TOPIC_MASK_ALL, &c);
+    printf("   → 丢弃：放行 %u 丢弃 %u；合并：放行 %u 合并 %u，补发 %d：%s\n",
+           d.passed, d.dropped, c.passed, c.coalesced, flushed,
+           (d.passed == 2 && d.dropped == 3 && c.passed == 3 && c.coalesced == 2 && flushed == 1) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_SetRateLimit(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, NULL);
+    EVENT_SetRateLimit(EVENT_USER_LOGIN, EVENT_TOPIC_MASK_ALL, NULL);
+}
+
+/* 限流与信用叠加：取得令牌但因没有信用而入队失败时，令牌归还、不计为放行 */
+void demo_rate_refund(void)
+{
+    printf("\n\033[1;35m→ 限流 + 信用：突发 2 个令牌、1 个信用，连发 3 个，分发后再发 1 个\033[0m\n");
+    EventRateLimit_t drop = { 10, 2, EVENT_RATE_DROP, 0 };
+    EVENT_SetClock(EVENT_VirtualClock, NULL);       // 时钟不走，令牌不补充
+    EVENT_SetRateLimit(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, &drop);
+    int ch = EVENT_SetCredits(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, 1);
+    EventRateStats_t st0, st;                       // 规则与通道沿用上面的演示，统计取差值
+    EVENT_GetRateStats(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, &st0);
+    uint32_t denied0 = EVENT_GetCreditDenied(ch);
+    int accepted = 0;
+    for (int i = 0; i < 3; i++) {
+        accepted += (EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, NULL, 0) == 0);
+    }
+    EVENT_Process();                                // 归还信用
+    int later = (EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, NULL, 0) == 0);
+    EVENT_Process();
+
+    EVENT_GetRateStats(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, &st);
+    uint32_t denied = EVENT_GetCreditDenied(ch) - denied0;
+    uint32_t passed = st.passed - st0.passed;
+    uint32_t dropped = st.dropped - st0.dropped;
+    printf("   → 连发入队 %d 个，信用拒绝 %u 次，之后再发%s，放行 %u 丢弃 %u：%s\n",
+           accepted, denied, later ? "成功" : "失败", passed, dropped,
+           (accepted == 1 && denied == 2 && later && passed == 2 && dropped == 0) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_SetCredits(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, 0);
+    EVENT_SetRateLimit(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, NULL);
+    EVENT_SetClock(NULL, NULL);
+}
+
+/* 信用流控：4 个信用，生产者在信用用完后停下，等分发归还后继续 */
+void demo_credits(void)
+{
+    printf("\n\033[1;35m→ 信用流控：传感器通道 4 个信用，生产者查询到有信用才发布，循环 6 次后再强行发布 1 次\033[0m\n");
+    int ch = EVENT_SetCredits(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, 4);
+    int accepted = 0;
+    for (int i = 0; i < 6; i++) {
+        if (EVENT_GetCredits(ch) > 0 && EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, NULL, 0) == 0) {
+            accepted++;
+        }
+    }
+    EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, NULL, 0);   // 没有信用，被拒绝
+    int before = EVENT_GetCredits(ch);
+    EVENT_Process();
+    printf("   → 入队 %d 个，拒绝 %u 次，分发前信用 %d，分发后 %d：%s\n", accepted,
+           EVENT_GetCreditDenied(ch), before, EVENT_GetCredits(ch),
+           (accepted == 4 && EVENT_GetCreditDenied(ch) == 1 && before == 0 && EVENT_GetCredits(ch) == 4) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_SetCredits(EVENT_SENSOR_DATA, EVENT_TOPIC_MASK_ALL, 0);
+}
+
+#if EVENT_DEADLINE_ENABLE
+static char g_edf_order[4];
+static int  g_edf_count = 0;
+
+static void on_control(Event_t* e, void* arg)
+{
+    (void)arg;
+    if (g_edf_count < 3) {
+        g_edf_order[g_edf_count++] = (char)e->data[0];
+    }
+}
+
+/* 截止时间优先：三条控制命令按截止时间而不是发布顺序分发 */
+void demo_deadline(void)
+{
+    printf("\n\033[1;35m→ 截止时间优先：依次发布截止 30/10/20 ms 的命令 A/B/C\033[0m\n");
+    EVENT_SetClock(EVENT_VirtualClock, NULL);
+    EVENT_Subscribe(EVENT_CONTROL_CMD, on_control, NULL);
+    EVENT_SetProcessMode(EVENT_PROCESS_EDF);
+    EVENT_PublishDeadline(EVENT_CONTROL_CMD, PRIORITY_NORMAL, 30, "A", 1);
+    EVENT_PublishDeadline(EVENT_CONTROL_CMD, PRIORITY_NORMAL, 10, "B", 1);
+    EVENT_PublishDeadline(EVENT_CONTROL_CMD, PRIORITY_NORMAL, 20, "C", 1);
+    EVENT_VirtualClockAdvance(15);         // B 已超时
+    EVENT_Process();
+    EventDeadlineStats_t stats;
+    EVENT_GetDeadlineStats(&stats);
+    printf("   → 分发顺序 %s，错过截止 %u 个：%s\n", g_edf_order, stats.missed,
+           (strcmp(g_edf_order, "BCA") == 0 && stats.missed == 1) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Unsubscribe(EVENT_CONTROL_CMD, on_control, NULL);
+    EVENT_SetProcessMode(EVENT_PROCESS_DEFERRED);
+    EVENT_SetClock(NULL, NULL);
+}
+#endif
+
+// 服务方：收到查询后直接应答，温度放大 10 倍
+static void on_query_temp(Event_t* e, void* arg)
+{
+    (void)arg;
+    uint8_t sensor = EVENT_REQUEST_DATA(e)[0];
+    int16_t temp = (int16_t)(360 + sensor);
+    EVENT_Reply(e, &temp, sizeof(temp));
+}
+
+// 请求/应答：一次正常应答，一次无人服务的请求按真实时间超时
+void demo_request(void)
+{
+    printf("\n\033[1;35m→ 请求/应答：查询 2 号传感器温度，再向无人服务的类型发请求（超时 100 ms）\033[0m\n");
+    EVENT_RequestInit();
+    EVENT_Subscribe(EVENT_QUERY_TEMP, on_query_temp, NULL);
+
+    EventFuture_t f;
+    uint8_t sensor = 2;
+    int16_t temp = 0;
+    EVENT_RequestAsync(EVENT_QUERY_TEMP, &sensor, 1, 100, &f);
+    Event_ReplyStatus_t ok = EVENT_FutureWait(&f);
+    if (ok == EVENT_REPLY_OK && f.data_size == sizeof(temp)) {
+        memcpy(&temp, f.data, sizeof(temp));
+    }
+
+    uint32_t start = EVENT_GetTime();
+    EVENT_RequestAsync(EVENT_CONTROL_CMD, &sensor, 1, 100, &f);   // EVENT_CONTROL_CMD 没有服务方
+    Event_ReplyStatus_t timeout = EVENT_FutureWait(&f);
+    uint32_t waited = EVENT_GetTime() - start;
+
+    printf("   → 应答 %d（温度 %d），超时请求结果 %d，等待 %u ms：%s\n", ok, temp, timeout, waited,
+           (ok == EVENT_REPLY_OK && temp == 362 && timeout == EVENT_REPLY_TIMEOUT && waited >= 100) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Unsubscribe(EVENT_QUERY_TEMP, on_query_temp, NULL);
+}
+
+// 窗口聚合：滑动窗口 1000 ms、每 300 ms 汇总一次，采样是 4 字节无符号小端数
+#define AGG_SUMMARY_MAX 12
+static EventAggSummary_t g_agg_summaries[AGG_SUMMARY_MAX];
+static int g_agg_summary_count = 0;
+
+static void on_agg_summary(Event_t* e, void* arg)
+{
+    (void)arg;
+    if (g_agg_summary_count < AGG_SUMMARY_MAX) {
+        memcpy(&g_agg_summaries[g_agg_summary_count++], e->data, sizeof(EventAggSummary_t));
+    }
+}
+
+static void agg_sample_at(uint32_t t, uint32_t value)
+{
+    uint8_t data[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    EVENT_VirtualClockSet(t);
+    EVENT_Publish(EVENT_AGG_SAMPLE, PRIORITY_NORMAL, data, sizeof(data));
+    EVENT_Process();
+}
+
+void demo_aggregate(void)
+{
+    printf("\n\033[1;35m→ 窗口聚合：滑动窗口 1000 ms、步长 300 ms，中间有 3 秒空档；每个采样落在 3~4 个窗口中\033[0m\n");
+    EventAggConfig_t cfg = { EVENT_AGG_SAMPLE, EVENT_AGG_SUMMARY, EVENT_AGG_SLIDING, 1000, 300,
+                             0, 4, 0, 0 };
+    EVENT_SetClock(EVENT_VirtualClock, NULL);
+    EVENT_Subscribe(EVENT_AGG_SUMMARY, on_agg_summary, NULL);
+    int id = EVENT_AggregateStart(&cfg);
+
+    agg_sample_at(1000, 10);
+    agg_sample_at(1500, 20);
+    agg_sample_at(1600, 0x80000000u);   // 超出 int32_t，丢弃并计数
+    agg_sample_at(5300, 30);            // 关闭空档前的窗口，之后从包含 5300 的最早窗口 [4500, 5500) 继续
+    EVENT_VirtualClockSet(6100);
+    EVENT_AggregatePoll();
+    EVENT_Process();
+
+    /* 1000、1500 两个采样落在起点 300~1500 的 5 个窗口中，5300 落在起点 4500~5100 的 3 个窗口中 */
+    static const uint32_t starts[] = { 300, 600, 900, 1200, 1500, 4500, 4800, 5100 };
+    static const uint32_t counts[] = { 1, 2, 2, 1, 1, 1, 1, 1 };
+    int aligned = (g_agg_summary_count == 8);
+    for (int i = 0; i < g_agg_summary_count; i++) {
+        const EventAggSummary_t* s = &g_agg_summaries[i];
+        printf("   → [%u, %u) 共 %u 个，最小 %d 最大 %d 平均 %d\n", s->start, s->end, s->count,
+               s->min, s->max, s->mean);
+        aligned &= (i < 8 && s->start == starts[i] && s->end - s->start == 1000 && s->count == counts[i]);
+    }
+    const EventAggSummary_t* last = &g_agg_summaries[g_agg_summary_count - 1];
+    printf("   → 汇总 %d 个，丢弃 %u 个，包含采样的窗口都已发布：%s\n", g_agg_summary_count,
+           EVENT_AggregateGetDropped(id),
+           (aligned && EVENT_AggregateGetDropped(id) == 1 &&
+            g_agg_summaries[1].mean == 15 && last->max == 30) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+
+    EVENT_AggregateStop(id);
+    EVENT_Unsubscribe(EVENT_AGG_SUMMARY, on_agg_summary, NULL);
+    EVENT_SetClock(NULL, NULL);
+}
+
+// 流水线：原始读数 → 平滑 → 超限报警，两级都在分发线程中融合调用，中间结果不经过总线
+static int g_pipe_last = 0;
+static int g_pipe_alarms = 0;
+static int g_pipe_smoothed_seen = 0;
+
+static int stage_smooth(const Event_t* in, Event_t* out, void* arg)
+{
+    (void)arg;
+    g_pipe_last = (g_pipe_last + in->data[0]) / 2;     // 与上一次结果取平均
+    out->data[0] = (uint8_t)g_pipe_last;
+    out->data_size = 1;
+    return 1;
+}
+
+static int stage_threshold(const Event_t* in, Event_t* out, void* arg)
+{
+    uint8_t limit = *(const uint8_t*)arg;
+    out->data[0] = in->data[0];
+    out->data_size = 1;
+    return in->data[0] > limit;     // 未超限时不向下游传递
+}
+
+static void on_pipe_alarm(Event_t* e, void* arg)
+{
+    (void)e;
+    (void)arg;
+    g_pipe_alarms++;
+}
+
+static void on_pipe_smoothed(Event_t* e, void* arg)
+{
+    (void)e;
+    (void)arg;
+    g_pipe_smoothed_seen++;
+}
+
+void demo_pipeline(void)
+{
+    printf("\n\033[1;35m→ 流水线：原始读数 → 平滑 → 超限报警（阈值 50）\033[0m\n");
+    static const uint8_t limit = 50;
+    static const uint8_t readings[] = { 20, 100, 100, 10, 10 };   // 平滑后 10、55、77、43、26
+    EVENT_SetProcessMode(EVENT_PROCESS_DEFERRED);
+    EVENT_PipelineAddStage(EVENT_PIPE_RAW, EVENT_PIPE_SMOOTHED, stage_smooth, NULL, 0);
+    EVENT_PipelineAddStage(EVENT_PIPE_SMOOTHED, EVENT_PIPE_ALARM, stage_threshold, (void*)&limit, 0);
+    EVENT_PipelineBuild();
+    EVENT_Subscribe(EVENT_PIPE_ALARM, on_pipe_alarm, NULL);
+    EVENT_Subscribe(EVENT_PIPE_SMOOTHED, on_pipe_smoothed, NULL);  // 中间类型，收不到
+
+    for (size_t i = 0; i < sizeof(readings); i++) {
+        EVENT_Publish(EVENT_PIPE_RAW, PRIORITY_NORMAL, &readings[i], 1);
+    }
+    while (EVENT_Process() > 0) {
+        EVENT_PipelineRun(0);
+    }
+
+    printf("   → 报警 %d 次，总线上的平滑读数订阅者收到 %d 次：%s\n", g_pipe_alarms, g_pipe_smoothed_seen,
+           (g_pipe_alarms == 2 && g_pipe_smoothed_seen == 0) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Unsubscribe(EVENT_PIPE_ALARM, on_pipe_alarm, NULL);
+    EVENT_Unsubscribe(EVENT_PIPE_SMOOTHED, on_pipe_smoothed, NULL);
+    EVENT_PipelineReset();
+}
+
+// 过滤订阅：总线在回调前判断数据字段和优先级，逐个分发与分组批量判断的结果应一致
+static void on_filtered(Event_t* e, void* arg)
+{
+    (void)e;
+    (*(int*)arg)++;
+}
+
+void demo_filter(Event_ProcessMode_t mode, const char* mode_name)
+{
+    printf("\n\033[1;35m→ 过滤订阅（%s模式）：data[0] == 3；大端 data[1..2] >= 0x0100 且优先级 1~2\033[0m\n", mode_name);
+    static const uint8_t samples[][3] = { {3, 0x00, 0x00}, {3, 0x02, 0x00}, {1, 0x03, 0x00},
+                                          {3, 0xFF, 0xFF}, {2, 0x01, 0x00} };
+    static const uint8_t prio[] = { 1, 2, 0, 2, 1 };
+    static const uint8_t size[] = { 3, 3, 3, 1, 3 };     // 第 4 个只有 1 字节，不满足第二个条件
+    EventFilter_t eq = { 0xFF, 3, EVENT_FILTER_EQ, 0, 1, 0, 0, 255 };
+    EventFilter_t ge = { 0xFFFF, 0x0100, EVENT_FILTER_GE, 1, 2, 1, 1, 2 };
+    int eq_hits = 0, ge_hits = 0;
+    EVENT_SetProcessMode(mode);
+    EVENT_SubscribeFiltered(EVENT_FILTER_TEST, &eq, on_filtered, &eq_hits);
+    EVENT_SubscribeFiltered(EVENT_FILTER_TEST, &ge, on_filtered, &ge_hits);
+    for (int i = 0; i < 5; i++) {
+        EVENT_Publish(EVENT_FILTER_TEST, prio[i], samples[i], size[i]);
+    }
+    EVENT_Process();
+    printf("   → 第一个条件命中 %d 个，第二个命中 %d 个：%s\n", eq_hits, ge_hits,
+           (eq_hits == 3 && ge_hits == 2) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_Unsubscribe(EVENT_FILTER_TEST, on_filtered, &eq_hits);
+    EVENT_Unsubscribe(EVENT_FILTER_TEST, on_filtered, &ge_hits);
+    EVENT_SetProcessMode(EVENT_PROCESS_DEFERRED);
+}
+
+// 通配订阅：按层级主题匹配，"1/2/+" 与 "1/+/+" 各收到自己范围内的事件
+static void on_wildcard(Event_t* e, void* arg)
+{
+    (void)e;
+    (*(int*)arg)++;
+}
+
+void demo_wildcard(void)
+{
+    printf("\n\033[1;35m→ 通配订阅：\"1/2/+\" 与 \"1/+/+\"，发布 1/2/5、1/3/0、2/2/0\033[0m\n");
+    int l2_hits = 0, l1_hits = 0;
+    EVENT_SubscribeMask(EVENT_TOPIC(1, 2, 0), EVENT_TOPIC_MASK_L2, on_wildcard, &l2_hits);
+    EVENT_SubscribeMask(EVENT_TOPIC(1, 0, 0), EVENT_TOPIC_MASK_L1, on_wildcard, &l1_hits);
+    EVENT_Publish(EVENT_TOPIC(1, 2, 5), PRIORITY_NORMAL, NULL, 0);
+    EVENT_Publish(EVENT_TOPIC(1, 3, 0), PRIORITY_NORMAL, NULL, 0);
+    EVENT_Publish(EVENT_TOPIC(2, 2, 0), PRIORITY_NORMAL, NULL, 0);
+    EVENT_Process();
+    int unsub = EVENT_UnsubscribeMask(EVENT_TOPIC(1, 2, 0), EVENT_TOPIC_MASK_L2, on_wildcard, &l2_hits);
+    EVENT_Publish(EVENT_TOPIC(1, 2, 5), PRIORITY_NORMAL, NULL, 0);   // 只剩 "1/+/+"
+    EVENT_Process();
+    EVENT_UnsubscribeMask(EVENT_TOPIC(1, 0, 0), EVENT_TOPIC_MASK_L1, on_wildcard, &l1_hits);
+    printf("   → \"1/2/+\" 收到 %d 个，\"1/+/+\" 收到 %d 个：%s\n", l2_hits, l1_hits,
+           (l2_hits == 1 && l1_hits == 3 && unsub == 0) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+}
+
+// 分组分发：同一批事件按类型连续分发，类型内保持到达顺序；
+// 没有订阅者的类型排在最前，只交给观察者；观察者在每个类型的订阅者之后收到该类型的事件
+static char g_group_log[32];
+static int  g_group_len = 0;
+
+static void group_log(char tag, char seq)
+{
+    if (g_group_len + 2 < (int)sizeof(g_group_log)) {
+        g_group_log[g_group_len++] = tag;
+        g_group_log[g_group_len++] = seq;
+        g_group_log[g_group_len] = '\0';
+    }
+}
+
+static void on_group_event(Event_t* e, void* arg)
+{
+    (void)arg;
+    group_log((char)(e->data[0] - 'A' + 'a'), (char)e->data[1]);     // 订阅者记小写
+}
+
+static void on_group_observer(Event_t* e, void* arg)
+{
+    (void)arg;
+    group_log((char)e->data[0], (char)e->data[1]);                   // 观察者记大写
+}
+
+void demo_grouped(void)
+{
+    printf("\n\033[1;35m→ 分组分发：依次发布 A1 B1 A2 C1 B2 A3，A、B 有订阅者，C 只有观察者\033[0m\n");
+    static const char* order[] = { "A1", "B1", "A2", "C1", "B2", "A3" };
+    g_group_len = 0;
+    g_group_log[0] = '\0';
+    EVENT_SetProcessMode(EVENT_PROCESS_GROUPED);
+    EVENT_Subscribe(EVENT_GROUP_A, on_group_event, NULL);
+    EVENT_Subscribe(EVENT_GROUP_B, on_group_event, NULL);
+    EVENT_RegisterObserver(on_group_observer, NULL);
+    for (int i = 0; i < 6; i++) {
+        Event_Type_t type = (Event_Type_t)(EVENT_GROUP_A + (order[i][0] - 'A'));
+        EVENT_Publish(type, PRIORITY_NORMAL, order[i], 2);
+    }
+    EVENT_Process();
+    EVENT_UnregisterObserver(on_group_observer);
+    EVENT_Unsubscribe(EVENT_GROUP_A, on_group_event, NULL);
+    EVENT_Unsubscribe(EVENT_GROUP_B, on_group_event, NULL);
+    EVENT_SetProcessMode(EVENT_PROCESS_DEFERRED);
+    printf("   → 分发顺序 %s：%s\n", g_group_log,
+           strcmp(g_group_log, "C1a1a2a3A1A2A3b1b2B1B2") == 0 ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+}
+
+// actor：分发只把事件放进邮箱，由 actor 在自己的时隙中处理；这里在同一线程中依次调用
+static int g_actor_sum = 0;
+
+static void on_actor_event(Event_t* e, void* arg)
+{
+    (void)arg;
+    g_actor_sum += e->data[0];
+}
+
+void demo_actor(void)
+{
+    printf("\n\033[1;35m→ actor：发布 1、2、3，分发后邮箱中有 3 个，处理后累加为 6\033[0m\n");
+    g_actor_sum = 0;
+    EventActor_t* actor = EVENT_ActorCreate(on_actor_event, NULL);
+    EVENT_ActorSubscribe(actor, EVENT_ACTOR_TEST);
+    for (uint8_t i = 1; i <= 3; i++) {
+        EVENT_Publish(EVENT_ACTOR_TEST, PRIORITY_NORMAL, &i, 1);
+    }
+    EVENT_Process();
+    int pending = EVENT_ActorGetPending(actor);
+    int before = g_actor_sum;
+    int drained = EVENT_ActorDrain(actor, 16);
+    printf("   → 分发后待处理 %d 个、累加 %d，处理 %d 个后累加 %d：%s\n",
+           pending, before, drained, g_actor_sum,
+           (pending == 3 && before == 0 && drained == 3 && g_actor_sum == 6) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+    EVENT_ActorDestroy(actor);
+}
+
+// 订阅抖动：回调中反复订阅、取消订阅，取消订阅不能失败，已取消的回调不再被调用
+#define CHURN_ROUNDS    40
+static int churn_failed;
+static int churn_calls;
+
+static void churn_noop(Event_t* e, void* arg)
+{
+    (void)e;
+    (void)arg;
+    churn_calls++;
+}
+
+static void on_churn(Event_t* e, void* arg)
+{
+    (void)e;
+    (void)arg;
+    for (int i = 0; i < CHURN_ROUNDS; i++) {
+        churn_failed += EVENT_Subscribe(EVENT_CHURN_TEST, churn_noop, NULL) != 0;
+        churn_failed += EVENT_Unsubscribe(EVENT_CHURN_TEST, churn_noop, NULL) != 0;
+        churn_failed += EVENT_SubscribeMask(EVENT_CHURN_TEST, 0xFFFF, churn_noop, NULL) != 0;
+        churn_failed += EVENT_UnsubscribeMask(EVENT_CHURN_TEST, 0xFFFF, churn_noop, NULL) != 0;
+    }
+}
+
+void demo_churn(void)
+{
+    printf("\n\033[1;35m→ 订阅抖动：一个回调中订阅/取消订阅 %d 对\033[0m\n", CHURN_ROUNDS * 2);
+    churn_failed = 0;
+    churn_calls = 0;
+    EVENT_Subscribe(EVENT_CHURN_TEST, on_churn, NULL);
+    EVENT_Publish(EVENT_CHURN_TEST, PRIORITY_LOW, NULL, 0);
+    EVENT_Publish(EVENT_CHURN_TEST, PRIORITY_LOW, NULL, 0);
+    EVENT_Process();
+    EVENT_Unsubscribe(EVENT_CHURN_TEST, on_churn, NULL);
+
+    // 抖动之后订阅表仍然可用
+    EVENT_Subscribe(EVENT_CHURN_TEST, churn_noop, NULL);
+    EVENT_Publish(EVENT_CHURN_TEST, PRIORITY_LOW, NULL, 0);
+    EVENT_Process();
+    EVENT_Unsubscribe(EVENT_CHURN_TEST, churn_noop, NULL);
+
+    printf("   → 失败 %d 次，之后收到 %d 次：%s\n", churn_failed, churn_calls,
+           (churn_failed == 0 && churn_calls == 1) ? "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+}
+
+#if EVENT_STATIC_SUBSCRIPTIONS
+// 静态订阅：订阅关系全部来自 event_static_table.h（上面的嵌套发布已经经由表中的 on_chain_step 分发），
+// 运行期订阅与观察者注册都应被拒绝
+static void on_static_unused(Event_t* e, void* arg)
+{
+    (void)e;
+    (void)arg;
+}
+
+void demo_static_table(void)
+{
+    printf("\n\033[1;35m→ 静态订阅表：运行期订阅、取消订阅与观察者注册都应返回 -1\033[0m\n");
+    int sub = EVENT_Subscribe(EVENT_USER_LOGIN, on_static_unused, NULL);
+    int unsub = EVENT_Unsubscribe(EVENT_BUTTON_PRESS, on_button_press, "启动按钮");
+    int obs = EVENT_RegisterObserver(on_static_unused, NULL);
+    printf("   → 订阅 %d，取消订阅 %d，注册观察者 %d：%s\n", sub, unsub, obs,
+           (sub == -1 && unsub == -1 && obs == -1) ?
+           "\033[1;32m通过\033[0m" : "\033[1;31m失败\033[0m");
+}
+#endif
+
 int main(void)
 {
-    printf("\033[1;34m========== ¼ϵͳʾʼ ==========\033[0m\n\n");
+    printf("\033[1;34m========== 事件系统完整演示开始 ==========\033[0m\n\n");
 
-    EVENT_Init();  // ʼ
+    EVENT_Init();  // 初始化
 
-    // ĸ¼
-    EVENT_Subscribe(EVENT_BUTTON_PRESS, on_button_press, "ť");
-    EVENT_Subscribe(EVENT_BUTTON_PRESS, on_button_press, "ֹͣť");
+    // 订阅各种事件
+    EVENT_Subscribe(EVENT_BUTTON_PRESS, on_button_press, "启动按钮");
+    EVENT_Subscribe(EVENT_BUTTON_PRESS, on_button_press, "停止按钮");
     EVENT_Subscribe(EVENT_SENSOR_DATA, on_sensor_data, NULL);
 
     int alert_level = 3;
     EVENT_Subscribe(EVENT_SYSTEM_ALERT, on_system_alert, &alert_level);
 
-    // עȫֹ۲ߣῴ¼
+    // 注册全局观察者（会看到所有事件）
     EVENT_RegisterObserver(global_observer, NULL);
 
-    printf("\033[1;35m ĺ͹۲עɣʼ¼...\033[0m\n\n");
+    printf("\033[1;35m→ 订阅和观察者注册完成，开始发布事件...\033[0m\n\n");
 
-    // ¼
+    // 发布各种事件
     EVENT_Publish(EVENT_BUTTON_PRESS, PRIORITY_HIGH, NULL, 0);
 
-    uint8_t sensor_data[] = {0x01, 0x68};  // ʾ36.8C  0x0168 (368)
+    uint8_t sensor_data[] = {0x01, 0x68};  // 示例：36.8°C → 0x0168 (368)
     EVENT_Publish(EVENT_SENSOR_DATA, PRIORITY_NORMAL, sensor_data, sizeof(sensor_data));
 
     const char* login_user = "admin";
     EVENT_Publish(EVENT_USER_LOGIN, PRIORITY_NORMAL, login_user, strlen(login_user) + 1);
 
-    EVENT_Publish(EVENT_SYSTEM_ALERT, PRIORITY_HIGH, "Դ", 10);
+    EVENT_Publish(EVENT_SYSTEM_ALERT, PRIORITY_HIGH, "电源故障", 10);
 
-    // ¼ؼһ
-    printf("\033[1;35m ʼе¼...\033[0m\n\n");
+    // 处理所有事件（关键一步！）
+    printf("\033[1;35m→ 开始处理队列中的事件...\033[0m\n\n");
     int processed = EVENT_Process();
 
-    printf("\033[1;32mι %d ¼\033[0m\n", processed);
-    printf("ǰʣ¼: %u \n", EVENT_GetCount());
+    printf("\033[1;32m本次共处理了 %d 个事件\033[0m\n", processed);
+    printf("当前队列剩余事件: %u 个\n\n", EVENT_GetCount());
+
+    // 回调中发布事件：延后模式分多轮处理，立即模式一轮处理完
+    EVENT_UnregisterObserver(global_observer);
+    EVENT_Subscribe(EVENT_CHAIN_STEP, on_chain_step, NULL);
+    demo_nested_publish(EVENT_PROCESS_DEFERRED, "延后");
+    demo_nested_publish(EVENT_PROCESS_IMMEDIATE, "立即");
+    demo_virtual_clock();
+    demo_debounce();
+    demo_rate_limit();
+    demo_credits();
+    demo_rate_refund();
+#if !EVENT_STATIC_SUBSCRIPTIONS
+    // 以下演示都在运行期订阅，静态订阅模式下订阅关系由 event_static_table.h 给出
+    demo_request();
+    demo_aggregate();
+    demo_pipeline();
+    demo_filter(EVENT_PROCESS_DEFERRED, "延后");
+    demo_filter(EVENT_PROCESS_GROUPED, "分组");
+    demo_wildcard();
+    demo_grouped();
+    demo_actor();
+    demo_churn();
+#if EVENT_DEADLINE_ENABLE
+    demo_deadline();
+#endif
+#else
+    demo_static_table();
+#endif
 
-    printf("\n\033[1;34m========== ʾ ==========\033[0m\n");
+    printf("\n\033[1;34m========== 演示结束 ==========\033[0m\n");
 
-    // ͣôڲˣDev-C++ ر
-    printf("\nس˳...");
+    // 暂停让窗口不闪退（Dev-C++ 必备）
+    printf("\n按回车键退出程序...");
     getchar();
 
     return 0;
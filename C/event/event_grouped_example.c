@@ -0,0 +1,82 @@
+/* event_grouped_example.c
+ * 分组分发与并发订阅：主线程按分组模式发布并分发，另一线程同时订阅新的类型；
+ * 批处理期间新分配的类型槽位归入 0 号桶，检查每个事件都恰好交给观察者一次
+ * 编译：gcc -std=c99 -pthread -DEVENT_DEBUG_ENABLE=0 event.c event_grouped_example.c -o event_grouped_example
+ * 仅适用于 POSIX 系统
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#include "event.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define TYPE_BASE       100
+#define TYPE_COUNT      24      // 每轮新订阅的类型数，不超过 EVENT_MAX_COUNT
+#define ROUNDS          200
+
+static unsigned long g_observed = 0;
+static unsigned long g_delivered = 0;
+static volatile int g_subscribing = 0;
+
+static void on_any(Event_t* event, void* arg)
+{
+    (void)event;
+    (void)arg;
+    g_observed++;
+}
+
+static void on_new_type(Event_t* event, void* arg)
+{
+    (void)event;
+    (void)arg;
+    g_delivered++;
+}
+
+/* 订阅线程：逐个订阅新类型，每次之后让出 CPU，使订阅尽量落在分发的批处理之间 */
+static void* subscriber_main(void* arg)
+{
+    (void)arg;
+    for (int k = 0; k < TYPE_COUNT; k++) {
+        EVENT_Subscribe((Event_Type_t)(TYPE_BASE + k), on_new_type, NULL);
+        sched_yield();
+    }
+    __atomic_store_n(&g_subscribing, 0, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int main(void)
+{
+    unsigned long published = 0;
+    int failed = 0;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        pthread_t thread;
+        EVENT_Init();
+        EVENT_SetProcessMode(EVENT_PROCESS_GROUPED);
+        EVENT_RegisterObserver(on_any, NULL);
+        g_subscribing = 1;
+        pthread_create(&thread, NULL, subscriber_main, NULL);
+
+        while (__atomic_load_n(&g_subscribing, __ATOMIC_ACQUIRE)) {
+            for (int k = 0; k < TYPE_COUNT; k++) {
+                if (EVENT_Publish((Event_Type_t)(TYPE_BASE + k), 0, NULL, 0) == 0) {
+                    published++;
+                }
+            }
+            EVENT_Process();
+        }
+        pthread_join(thread, NULL);
+        while (EVENT_Process() > 0) {
+        }
+        if (g_observed != published) {
+            failed++;
+            g_observed = published;     // 只统计出错的轮数
+        }
+    }
+
+    printf("共 %d 轮，发布 %lu 个，订阅者收到 %lu 个，观察者计数不符 %d 轮\n",
+           ROUNDS, published, g_delivered, failed);
+    printf("%s\n", (failed == 0 && g_delivered <= published) ? "通过" : "失败");
+    return 0;
+}
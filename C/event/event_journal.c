@@ -0,0 +1,173 @@
+/* event_journal.c
+ * 内存映射、按段轮转的事件日志
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L     /* ftruncate、mmap */
+#endif
+
+#include "event_journal.h"
+#include <string.h>
+#include <stdio.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+/* 日志状态，仅由分发线程访问 */
+static char     g_prefix[EVENT_JOURNAL_PATH_MAX];    /* 空串表示未打开 */
+static uint8_t* g_segment = NULL;       /* 当前段映射，NULL 表示未打开 */
+static int      g_fd = -1;
+static uint32_t g_sequence;
+static uint32_t g_dropped;
+
+static EventJournalHeader_t* journal_header(void)
+{
+    return (EventJournalHeader_t*)g_segment;
+}
+
+/* 解除当前段映射，truncate 为 1 时把文件截到实际使用的长度 */
+static void segment_close(uint8_t truncate)
+{
+    if (g_segment == NULL) {
+        return;
+    }
+    uint32_t used = journal_header()->used;
+    msync(g_segment, EVENT_JOURNAL_SEGMENT_SIZE, MS_ASYNC);
+    munmap(g_segment, EVENT_JOURNAL_SEGMENT_SIZE);
+    g_segment = NULL;
+    if (truncate) {
+        (void)ftruncate(g_fd, used);
+    }
+    close(g_fd);
+    g_fd = -1;
+}
+
+static int segment_open(uint32_t sequence)
+{
+    char path[EVENT_JOURNAL_PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s.%06u.evj", g_prefix, (unsigned)sequence) >= (int)sizeof(path)) {
+        return -1;
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, EVENT_JOURNAL_SEGMENT_SIZE) != 0) {
+        close(fd);
+        return -1;
+    }
+    void* p = mmap(NULL, EVENT_JOURNAL_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    g_segment = (uint8_t*)p;
+    g_fd = fd;
+    g_sequence = sequence;
+
+    EventJournalHeader_t* h = journal_header();
+    memset(h, 0, sizeof(*h));
+    h->magic = EVENT_JOURNAL_MAGIC;
+    h->version = EVENT_JOURNAL_VERSION;
+    h->header_size = (uint16_t)sizeof(EventJournalHeader_t);
+    h->record_header_size = (uint16_t)EVENT_HEADER_SIZE;
+    h->flags = EVENT_JOURNAL_FLAGS;
+    h->sequence = sequence;
+    h->capacity = EVENT_JOURNAL_SEGMENT_SIZE;
+    h->used = (uint32_t)sizeof(EventJournalHeader_t);
+    return 0;
+}
+
+int EVENT_JournalOpen(const char* prefix)
+{
+    if (prefix == NULL || strlen(prefix) + 12 > sizeof(g_prefix)) {
+        return -1;
+    }
+    segment_close(1);
+    strcpy(g_prefix, prefix);
+    g_dropped = 0;
+    return segment_open(0);
+}
+
+int EVENT_JournalFlush(void)
+{
+    if (g_segment == NULL) {
+        return -1;
+    }
+    return msync(g_segment, EVENT_JOURNAL_SEGMENT_SIZE, MS_ASYNC) == 0 ? 0 : -1;
+}
+
+int EVENT_JournalClose(void)
+{
+    g_prefix[0] = '\0';
+    if (g_segment == NULL) {
+        return -1;
+    }
+    segment_close(1);
+    return 0;
+}
+
+void EVENT_JournalObserver(Event_t* event, void* arg)
+{
+    (void)arg;
+    if (g_segment == NULL) {
+        if (g_prefix[0] != '\0') {
+            g_dropped++;    // 已打开但轮转失败
+        }
+        return;
+    }
+    uint32_t size = EVENT_JOURNAL_RECORD_SIZE(event->data_size);
+    EventJournalHeader_t* h = journal_header();
+    if (h->used + size > EVENT_JOURNAL_SEGMENT_SIZE) {
+        /* 当前段已满：轮转到下一段，这是写入路径上唯一会进入内核的地方 */
+        uint32_t next = g_sequence + 1;
+        segment_close(1);
+        if (segment_open(next) != 0) {
+            g_dropped++;
+            return;
+        }
+        h = journal_header();
+    }
+    uint8_t* dst = g_segment + h->used;
+    memcpy(dst, event, EVENT_HEADER_SIZE + event->data_size);
+    h->record_count++;
+    h->used += size;
+}
+
+uint32_t EVENT_JournalGetDropped(void)
+{
+    return g_dropped;
+}
+
+#else
+int EVENT_JournalOpen(const char* prefix)
+{
+    (void)prefix;
+    return -1;      // Windows 下暂不支持
+}
+
+int EVENT_JournalFlush(void)
+{
+    return -1;
+}
+
+int EVENT_JournalClose(void)
+{
+    return -1;
+}
+
+void EVENT_JournalObserver(Event_t* event, void* arg)
+{
+    (void)event;
+    (void)arg;
+}
+
+uint32_t EVENT_JournalGetDropped(void)
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,81 @@
+/* event_journal.h
+ * 事件日志：作为全局观察者把分发的每个事件追加到内存映射的二进制日志中
+ * 日志按段轮转，文件名为 "<前缀>.<段序号 6 位>.evj"；写入只是一次 memcpy，
+ * 系统调用只发生在打开、轮转、刷新和关闭时，刷新使用 msync(MS_ASYNC) 交给内核异步落盘
+ *
+ *   EVENT_JournalOpen("logs/bus");
+ *   EVENT_RegisterObserver(EVENT_JournalObserver, NULL);
+ *   // 静态订阅模式下在表中写 OBSERVER(EVENT_JournalObserver, NULL)
+ *   ...
+ *   EVENT_JournalClose();
+ *
+ * 观察者在分发线程中运行，Open/Flush/Close 也须在该线程调用
+ * 仅适用于 POSIX 系统，Windows 下各接口返回 -1
+ */
+
+#ifndef __EVENT_JOURNAL_H
+#define __EVENT_JOURNAL_H
+
+#include "event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==================== 配置宏 ==================== */
+#ifndef EVENT_JOURNAL_SEGMENT_SIZE
+#define EVENT_JOURNAL_SEGMENT_SIZE  (1024 * 1024)   // 每段文件字节数（含段头）
+#endif
+#ifndef EVENT_JOURNAL_PATH_MAX
+#define EVENT_JOURNAL_PATH_MAX      256             // 段文件路径最大长度
+#endif
+
+/* ==================== 文件格式 ==================== */
+/* 段文件 = 段头 + 连续的记录
+ * 每条记录是事件头部（与 Event_t 相同：8 字节，启用 EVENT_DEADLINE_ENABLE 时 12 字节）
+ * 加 data_size 字节数据，补齐到 4 字节；记录头部大小和截止时间标志写在段头中，
+ * 回放时与本程序的 Event_t 不一致的段被拒绝，不会错位解析
+ * 段头中的 used 在每条记录写完后更新，进程崩溃时已写入的记录仍可读出 */
+#define EVENT_JOURNAL_MAGIC     0x314A5645u     /* "EVJ1" */
+#define EVENT_JOURNAL_VERSION   2
+#define EVENT_JOURNAL_FLAG_DEADLINE 0x0001      /* 记录头部含截止时间 */
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;               /* 段头字节数，即第一条记录的偏移 */
+    uint32_t sequence;                  /* 段序号，从 0 开始 */
+    uint32_t capacity;                  /* 段文件字节数 */
+    uint32_t used;                      /* 已使用字节数（含段头） */
+    uint32_t record_count;              /* 本段记录数 */
+    uint16_t record_header_size;        /* 每条记录的事件头部字节数，即写入方的 EVENT_HEADER_SIZE */
+    uint16_t flags;                     /* EVENT_JOURNAL_FLAG_* */
+    uint32_t reserved;
+} EventJournalHeader_t;
+
+#define EVENT_JOURNAL_FLAGS     (EVENT_DEADLINE_ENABLE ? EVENT_JOURNAL_FLAG_DEADLINE : 0)
+
+/* 记录占用的字节数 */
+#define EVENT_JOURNAL_RECORD_SIZE(data_size) \
+    ((uint32_t)((EVENT_HEADER_SIZE + (data_size) + 3) & ~3u))
+
+EVENT_STATIC_ASSERT(sizeof(EventJournalHeader_t) == 32, journal_header_size);
+EVENT_STATIC_ASSERT(EVENT_JOURNAL_SEGMENT_SIZE >= 32 + EVENT_JOURNAL_RECORD_SIZE(EVENT_DATA_SIZE_MAX),
+                    journal_segment_holds_a_record);
+
+/* ==================== 公共API ==================== */
+/* 从 0 号段开始写，已存在的同名段被覆盖 */
+int EVENT_JournalOpen(const char* prefix);
+int EVENT_JournalFlush(void);           // 发起异步落盘
+int EVENT_JournalClose(void);           // 截掉末段未用部分并关闭
+
+/* 观察者回调，arg 未使用 */
+void EVENT_JournalObserver(Event_t* event, void* arg);
+
+uint32_t EVENT_JournalGetDropped(void); // 因轮转失败未能写入的事件数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_JOURNAL_H */
@@ -0,0 +1,239 @@
+/* event_pipeline.c
+ * 流水线：级之间的连接、同组融合调用与跨组环形队列
+ */
+
+#include "event_pipeline.h"
+#include <string.h>
+
+#define PIPE_CACHE_ALIGNED      __attribute__((aligned(EVENT_CACHE_LINE_SIZE)))
+#define PIPE_RING_MASK          (EVENT_PIPELINE_RING_SIZE - 1)
+#define PIPE_SINK               0xFF      /* 环形队列项的目标：发布到总线 */
+
+/* ==================== 级 ==================== */
+typedef struct {
+    Event_Type_t input;
+    Event_Type_t output;
+    EventStageFn_t fn;
+    void* arg;
+    uint8_t group;
+    uint8_t source;                     /* 入口级：已向总线订阅 input */
+    uint8_t next_count;                 /* 下游级数，0 表示出口 */
+    uint8_t next[EVENT_PIPELINE_STAGE_MAX];
+} Stage_t;
+
+static Stage_t g_stages[EVENT_PIPELINE_STAGE_MAX];
+static uint8_t g_stage_count = 0;
+static uint8_t g_built = 0;
+static uint32_t g_dropped = 0;
+
+/* ==================== 组间环形队列 ==================== */
+/* 每对 (生产组, 消费组) 一个单生产者/单消费者队列，双方索引分居不同缓存行 */
+typedef struct {
+    uint8_t stage;                      /* 目标级，PIPE_SINK 表示发布到总线 */
+    Event_t event;
+} RingItem_t;
+
+typedef struct {
+    PIPE_CACHE_ALIGNED uint32_t tail;   /* 生产组写 */
+    PIPE_CACHE_ALIGNED uint32_t head;   /* 消费组写 */
+    RingItem_t items[EVENT_PIPELINE_RING_SIZE];
+} Ring_t;
+
+static Ring_t g_rings[EVENT_PIPELINE_GROUP_MAX][EVENT_PIPELINE_GROUP_MAX];   /* [from][to] */
+
+static void ring_push(uint8_t from, uint8_t to, uint8_t stage, const Event_t* event)
+{
+    Ring_t* r = &g_rings[from][to];
+    uint32_t tail = r->tail;
+    if (tail - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) >= EVENT_PIPELINE_RING_SIZE) {
+        __atomic_add_fetch(&g_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    RingItem_t* item = &r->items[tail & PIPE_RING_MASK];
+    item->stage = stage;
+    memcpy(&item->event, event, EVENT_HEADER_SIZE + event->data_size);
+    __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/* ==================== 执行 ==================== */
+/* 在 s->group 所在线程中运行一级；同组下游直接调用，建图时已排除环，递归深度不超过级数 */
+static void stage_run(const Stage_t* s, const Event_t* in)
+{
+    Event_t out;
+    memcpy(&out, in, EVENT_HEADER_SIZE);
+    out.type = s->output;
+    out.data_size = 0;
+    if (!s->fn(in, &out, s->arg)) {
+        return;
+    }
+    if (out.data_size > EVENT_DATA_SIZE_MAX) {
+        out.data_size = EVENT_DATA_SIZE_MAX;
+    }
+
+    if (s->next_count == 0) {
+        if (s->group == 0) {
+            EVENT_Publish(out.type, out.priority, out.data, out.data_size);
+        } else {
+            ring_push(s->group, 0, PIPE_SINK, &out);
+        }
+        return;
+    }
+    for (int i = 0; i < s->next_count; i++) {
+        const Stage_t* n = &g_stages[s->next[i]];
+        if (n->group == s->group) {
+            stage_run(n, &out);
+        } else {
+            ring_push(s->group, n->group, s->next[i], &out);
+        }
+    }
+}
+
+/* 入口级的总线订阅回调，运行在分发线程（0 号组） */
+static void stage_entry(Event_t* event, void* arg)
+{
+    uint8_t index = (uint8_t)(uintptr_t)arg;
+    const Stage_t* s = &g_stages[index];
+    if (s->group == 0) {
+        stage_run(s, event);
+    } else {
+        ring_push(0, s->group, index, event);
+    }
+}
+
+/* ==================== 建图 ==================== */
+/* Kahn 拓扑排序：能全部排出说明无环 */
+static int graph_acyclic(void)
+{
+    uint8_t indegree[EVENT_PIPELINE_STAGE_MAX] = {0};
+    uint8_t ready[EVENT_PIPELINE_STAGE_MAX];
+    int head = 0, tail = 0;
+
+    for (int i = 0; i < g_stage_count; i++) {
+        for (int j = 0; j < g_stages[i].next_count; j++) {
+            indegree[g_stages[i].next[j]]++;
+        }
+    }
+    for (int i = 0; i < g_stage_count; i++) {
+        if (indegree[i] == 0) {
+            ready[tail++] = (uint8_t)i;
+        }
+    }
+    while (head < tail) {
+        const Stage_t* s = &g_stages[ready[head++]];
+        for (int j = 0; j < s->next_count; j++) {
+            if (--indegree[s->next[j]] == 0) {
+                ready[tail++] = s->next[j];
+            }
+        }
+    }
+    return tail == g_stage_count;
+}
+
+static void unsubscribe_sources(void)
+{
+    for (int i = 0; i < g_stage_count; i++) {
+        if (g_stages[i].source) {
+            EVENT_Unsubscribe(g_stages[i].input, stage_entry, (void*)(uintptr_t)i);
+            g_stages[i].source = 0;
+        }
+    }
+}
+
+/* ==================== 公共函数实现 ==================== */
+int EVENT_PipelineAddStage(Event_Type_t input, Event_Type_t output,
+                           EventStageFn_t fn, void* arg, uint8_t group)
+{
+    if (fn == NULL || group >= EVENT_PIPELINE_GROUP_MAX || g_built ||
+        g_stage_count >= EVENT_PIPELINE_STAGE_MAX) {
+        return -1;
+    }
+    Stage_t* s = &g_stages[g_stage_count];
+    memset(s, 0, sizeof(*s));
+    s->input = input;
+    s->output = output;
+    s->fn = fn;
+    s->arg = arg;
+    s->group = group;
+    return g_stage_count++;
+}
+
+int EVENT_PipelineBuild(void)
+{
+    if (g_built || g_stage_count == 0) {
+        return -1;
+    }
+    for (int i = 0; i < g_stage_count; i++) {
+        Stage_t* s = &g_stages[i];
+        s->next_count = 0;
+        for (int j = 0; j < g_stage_count; j++) {
+            if (g_stages[j].input == s->output) {
+                s->next[s->next_count++] = (uint8_t)j;
+            }
+        }
+    }
+    if (!graph_acyclic()) {
+        return -1;
+    }
+
+    for (int i = 0; i < g_stage_count; i++) {
+        Stage_t* s = &g_stages[i];
+        int fed = 0;
+        for (int j = 0; j < g_stage_count && !fed; j++) {
+            fed = (g_stages[j].output == s->input);
+        }
+        if (fed) {
+            continue;
+        }
+        if (EVENT_Subscribe(s->input, stage_entry, (void*)(uintptr_t)i) != 0) {
+            unsubscribe_sources();
+            return -1;
+        }
+        s->source = 1;
+    }
+    memset(g_rings, 0, sizeof(g_rings));
+    g_dropped = 0;
+    g_built = 1;
+    return 0;
+}
+
+int EVENT_PipelineReset(void)
+{
+    unsubscribe_sources();
+    g_stage_count = 0;
+    g_built = 0;
+    return 0;
+}
+
+int EVENT_PipelineRun(uint8_t group)
+{
+    if (!g_built || group >= EVENT_PIPELINE_GROUP_MAX) {
+        return 0;
+    }
+    int count = 0;
+    for (int from = 0; from < EVENT_PIPELINE_GROUP_MAX; from++) {
+        if (from == group) {
+            continue;
+        }
+        Ring_t* r = &g_rings[from][group];
+        uint32_t head = r->head;
+        uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const RingItem_t* item = &r->items[head & PIPE_RING_MASK];
+            if (item->stage == PIPE_SINK) {
+                EVENT_Publish(item->event.type, item->event.priority,
+                              item->event.data, item->event.data_size);
+            } else {
+                stage_run(&g_stages[item->stage], &item->event);
+            }
+            head++;
+            __atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t EVENT_PipelineGetDropped(void)
+{
+    return __atomic_load_n(&g_dropped, __ATOMIC_RELAXED);
+}
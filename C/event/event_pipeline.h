@@ -0,0 +1,65 @@
+/* event_pipeline.h
+ * 流水线：把"订阅类型 A、处理后发布类型 B"的多级处理声明为一张图，
+ * 中间结果不再每级都经过一次总线队列
+ *
+ *   EVENT_PipelineAddStage(RAW,      FILTERED, lowpass,   NULL, 0);  // 0 号组：分发线程
+ *   EVENT_PipelineAddStage(FILTERED, FEATURE,  extract,   NULL, 1);  // 1 号组：工作线程
+ *   EVENT_PipelineAddStage(FEATURE,  ALARM,    classify,  NULL, 1);
+ *   EVENT_PipelineBuild();
+ *   // 分发线程：EVENT_Process(); EVENT_PipelineRun(0);
+ *   // 工作线程：while (running) EVENT_PipelineRun(1);
+ *
+ * - 输入类型不由其他级产生的级是入口，向总线订阅该类型
+ * - 输出类型没有下游级时是出口，结果经 EVENT_Publish 发布到总线（由 0 号组发布）
+ * - 中间类型只在流水线内部流动，不经过总线；同组的下游级直接调用（融合为一条调用链），
+ *   跨组的下游级经两组之间的单生产者/单消费者环形队列传递，队列满时丢弃并计数
+ * - 因此在总线上订阅中间类型（上例的 FILTERED、FEATURE）收不到流水线产生的事件，
+ *   需要观察中间结果时，把它再声明为某一级的输出并让该级成为出口，或在处理函数中自行发布
+ * - 每个组由一个线程调用 EVENT_PipelineRun，0 号组须是调用 EVENT_Process 的线程
+ * - AddStage/Build/Reset 须在开始处理事件之前调用；静态订阅模式下不可用
+ */
+
+#ifndef __EVENT_PIPELINE_H
+#define __EVENT_PIPELINE_H
+
+#include "event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==================== 配置宏 ==================== */
+#ifndef EVENT_PIPELINE_STAGE_MAX
+#define EVENT_PIPELINE_STAGE_MAX    16    // 流水线级数
+#endif
+#ifndef EVENT_PIPELINE_GROUP_MAX
+#define EVENT_PIPELINE_GROUP_MAX    4     // 线程组数，0 号组是分发线程
+#endif
+#ifndef EVENT_PIPELINE_RING_SIZE
+#define EVENT_PIPELINE_RING_SIZE    64    // 组间环形队列深度（必须是 2 的幂）
+#endif
+
+EVENT_STATIC_ASSERT((EVENT_PIPELINE_RING_SIZE & (EVENT_PIPELINE_RING_SIZE - 1)) == 0,
+                    pipeline_ring_size_must_be_power_of_two);
+
+/* ==================== 类型定义 ==================== */
+/* 处理函数：out 的头部已按 in 填好（类型为本级输出类型），函数只需写 data/data_size，
+ * 也可以改优先级；返回 0 表示本事件不再向下游传递 */
+typedef int (*EventStageFn_t)(const Event_t* in, Event_t* out, void* arg);
+
+/* ==================== 公共API ==================== */
+int EVENT_PipelineAddStage(Event_Type_t input, Event_Type_t output,
+                           EventStageFn_t fn, void* arg, uint8_t group);   // 返回级编号
+int EVENT_PipelineBuild(void);          // 连接各级并订阅入口类型，图中有环时返回 -1
+int EVENT_PipelineReset(void);          // 取消订阅并清空所有级
+
+/* 在 group 对应的线程中调用，处理其他组送来的事件，返回处理数量 */
+int EVENT_PipelineRun(uint8_t group);
+
+uint32_t EVENT_PipelineGetDropped(void);    // 因组间队列满而丢弃的事件数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_PIPELINE_H */
@@ -0,0 +1,143 @@
+/* event_pipeline_example.c
+ * 跨组流水线示例：0 号组（分发线程）做第一级，1 号组在工作线程中做第二级，
+ * 结果经组间环形队列回到 0 号组发布到总线；检查数量与顺序，再在工作组停下时灌满环形队列，
+ * 检查超出部分被丢弃并计数、其余事件仍按顺序到达
+ * 编译：gcc -std=c99 -pthread event.c event_pipeline.c event_pipeline_example.c -o event_pipeline_example
+ * 仅适用于 POSIX 系统
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#include "event.h"
+#include "event_pipeline.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define EVENT_PIPE_IN       1       // 总线输入
+#define EVENT_PIPE_MID      2       // 组间中间类型
+#define EVENT_PIPE_OUT      3       // 总线输出
+#define SAMPLE_TOTAL        5000
+#define OVERFLOW            10      // 灌满环形队列时多发的事件数
+
+static volatile int g_running = 1;
+static uint32_t g_received = 0;
+static uint32_t g_last = 0;
+static int g_out_of_order = 0;
+static int g_bad_value = 0;
+
+/* 第一级（0 号组）：原样带上序号，附加序号的平方的低 8 位 */
+static int stage_tag(const Event_t* in, Event_t* out, void* arg)
+{
+    (void)arg;
+    uint32_t seq;
+    memcpy(&seq, in->data, sizeof(seq));
+    memcpy(out->data, &seq, sizeof(seq));
+    out->data[4] = (uint8_t)(seq * seq);
+    out->data_size = 5;
+    return 1;
+}
+
+/* 第二级（1 号组）：把附加值取反，出口结果由 0 号组发布 */
+static int stage_invert(const Event_t* in, Event_t* out, void* arg)
+{
+    (void)arg;
+    memcpy(out->data, in->data, 5);
+    out->data[4] = (uint8_t)~in->data[4];
+    out->data_size = 5;
+    return 1;
+}
+
+static void on_output(Event_t* event, void* arg)
+{
+    (void)arg;
+    uint32_t seq;
+    memcpy(&seq, event->data, sizeof(seq));
+    if (g_received > 0 && seq <= g_last) {
+        g_out_of_order++;
+    }
+    if (event->data[4] != (uint8_t)~(uint8_t)(seq * seq)) {
+        g_bad_value++;
+    }
+    g_last = seq;
+    g_received++;
+}
+
+static void* worker_main(void* arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&g_running, __ATOMIC_ACQUIRE)) {
+        if (EVENT_PipelineRun(1) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* 分发线程的一步：处理总线事件，再发布 1 号组送回的结果 */
+static void dispatch_step(void)
+{
+    EVENT_Process();
+    EVENT_PipelineRun(0);
+    EVENT_Process();
+}
+
+int main(void)
+{
+    pthread_t worker;
+    EVENT_Init();
+    EVENT_Subscribe(EVENT_PIPE_OUT, on_output, NULL);
+    EVENT_PipelineAddStage(EVENT_PIPE_IN, EVENT_PIPE_MID, stage_tag, NULL, 0);
+    EVENT_PipelineAddStage(EVENT_PIPE_MID, EVENT_PIPE_OUT, stage_invert, NULL, 1);
+    if (EVENT_PipelineBuild() != 0) {
+        printf("建图失败\n");
+        return 1;
+    }
+
+    /* 1. 工作线程运行时，在途事件不超过环形队列深度，应一个不丢且保持顺序 */
+    pthread_create(&worker, NULL, worker_main, NULL);
+    for (uint32_t seq = 0; seq < SAMPLE_TOTAL; seq++) {
+        while (seq - g_received >= EVENT_PIPELINE_RING_SIZE / 2) {
+            dispatch_step();
+            sched_yield();
+        }
+        EVENT_Publish(EVENT_PIPE_IN, 0, &seq, sizeof(seq));
+        dispatch_step();
+    }
+    while (g_received < SAMPLE_TOTAL) {
+        dispatch_step();
+        sched_yield();
+    }
+    __atomic_store_n(&g_running, 0, __ATOMIC_RELEASE);
+    pthread_join(worker, NULL);
+    int flow_ok = (g_received == SAMPLE_TOTAL && g_out_of_order == 0 && g_bad_value == 0 &&
+                   EVENT_PipelineGetDropped() == 0);
+    printf("跨组传递 %u 个，倒序 %d 个，结果错误 %d 个，丢弃 %u 个\n",
+           g_received, g_out_of_order, g_bad_value, EVENT_PipelineGetDropped());
+
+    /* 2. 1 号组停下时 0→1 环形队列被灌满，多出的事件丢弃并计数；
+     *    之后由主线程接替 1 号组（同一时刻仍只有一个线程运行该组），已入队的按顺序到达 */
+    uint32_t before = g_received;
+    uint32_t seq = SAMPLE_TOTAL;
+    for (int i = 0; i < EVENT_PIPELINE_RING_SIZE + OVERFLOW; i++, seq++) {
+        EVENT_Publish(EVENT_PIPE_IN, 0, &seq, sizeof(seq));
+        if (EVENT_GetCount() >= EVENT_QUEUE_SIZE / 2) {
+            EVENT_Process();
+        }
+    }
+    EVENT_Process();
+    uint32_t dropped = EVENT_PipelineGetDropped();
+    EVENT_PipelineRun(1);
+    while (EVENT_PipelineRun(0) > 0 || EVENT_GetCount() > 0) {
+        EVENT_Process();
+    }
+    uint32_t delivered = g_received - before;
+    int full_ok = (dropped == OVERFLOW && delivered == EVENT_PIPELINE_RING_SIZE &&
+                   g_last == SAMPLE_TOTAL + EVENT_PIPELINE_RING_SIZE - 1 &&
+                   g_out_of_order == 0 && g_bad_value == 0);
+    printf("环形队列满：丢弃 %u 个，之后到达 %u 个，最后序号 %u\n", dropped, delivered, g_last);
+
+    EVENT_PipelineReset();
+    printf("%s\n", (flow_ok && full_ok) ? "通过" : "失败");
+    return 0;
+}
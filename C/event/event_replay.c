@@ -0,0 +1,263 @@
+/* event_replay.c
+ * 事件日志回放
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L     /* mmap、clock_gettime、nanosleep */
+#endif
+
+#include "event_replay.h"
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32)
+/* 回放状态，仅由回放线程访问 */
+static char     g_prefix[EVENT_JOURNAL_PATH_MAX];
+static const uint8_t* g_segment = NULL;     /* 当前段的只读映射，NULL 表示已读完或未打开 */
+static size_t   g_segment_size;
+static uint32_t g_sequence;
+static uint32_t g_offset;                   /* 下一条记录在段内的偏移 */
+static uint32_t g_used;
+
+static uint8_t  g_mode;
+static double   g_speed;
+static uint8_t  g_started;                  /* 已发布第一条记录，g_base_* 有效 */
+static uint32_t g_base_timestamp;           /* 第一条记录的时间戳 */
+static double   g_base_ms;                  /* 发布第一条记录时的单调时间 */
+static uint32_t g_retries;                  /* 当前记录连续发布失败的次数 */
+static uint32_t g_skipped;
+static uint8_t  g_clock_saved;              /* 虚拟模式下已保存原时钟 */
+static EventClock_t g_saved_clock;
+static void*    g_saved_clock_arg;
+
+/* 单调时间（ms），不受系统时间调整影响 */
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void segment_unmap(void)
+{
+    if (g_segment != NULL) {
+        munmap((void*)g_segment, g_segment_size);
+        g_segment = NULL;
+    }
+}
+
+/* 映射指定段并校验段头，文件不存在或格式不符（包括记录头部与本程序的 Event_t 不同）时返回 -1 */
+static int segment_map(uint32_t sequence)
+{
+    char path[EVENT_JOURNAL_PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s.%06u.evj", g_prefix, (unsigned)sequence) >= (int)sizeof(path)) {
+        return -1;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(EventJournalHeader_t)) {
+        close(fd);
+        return -1;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return -1;
+    }
+
+    const EventJournalHeader_t* h = (const EventJournalHeader_t*)p;
+    if (h->magic != EVENT_JOURNAL_MAGIC || h->version != EVENT_JOURNAL_VERSION ||
+        h->header_size < sizeof(EventJournalHeader_t) ||
+        h->record_header_size != EVENT_HEADER_SIZE || h->flags != EVENT_JOURNAL_FLAGS ||
+        h->used < h->header_size || h->used > (uint64_t)st.st_size) {
+        munmap(p, (size_t)st.st_size);
+        return -1;
+    }
+    g_segment = (const uint8_t*)p;
+    g_segment_size = (size_t)st.st_size;
+    g_sequence = sequence;
+    g_offset = h->header_size;
+    g_used = h->used;
+    return 0;
+}
+
+/* 取下一条记录的头部，当前段读完时换到下一段；没有更多记录时返回 NULL */
+static const Event_t* next_record(void)
+{
+    while (g_segment != NULL) {
+        if (g_offset + EVENT_HEADER_SIZE <= g_used) {
+            const Event_t* rec = (const Event_t*)(g_segment + g_offset);
+            if (rec->data_size <= EVENT_DATA_SIZE_MAX &&
+                g_offset + EVENT_JOURNAL_RECORD_SIZE(rec->data_size) <= g_used) {
+                return rec;
+            }
+        }
+        uint32_t next = g_sequence + 1;
+        segment_unmap();
+        segment_map(next);
+    }
+    return NULL;
+}
+
+/* 重新发布一条记录，带截止时间的记录保留它与时间戳之间的间隔 */
+static int replay_publish(const Event_t* rec)
+{
+#if EVENT_DEADLINE_ENABLE
+    if (rec->deadline != EVENT_DEADLINE_NONE) {
+        return EVENT_PublishDeadline(rec->type, rec->priority, rec->deadline - rec->timestamp,
+                                     rec->data, rec->data_size);
+    }
+#endif
+    return EVENT_Publish(rec->type, rec->priority, rec->data, rec->data_size);
+}
+
+/* 记录的计划发布时间（ms，与 now_ms 同一时基） */
+static double due_ms(const Event_t* rec)
+{
+    double offset = (double)(uint32_t)(rec->timestamp - g_base_timestamp);
+    if (g_mode == EVENT_REPLAY_SCALED) {
+        offset /= g_speed;
+    }
+    return g_base_ms + offset;
+}
+
+int EVENT_ReplayOpen(const char* prefix, Event_ReplayMode_t mode, double speed)
+{
+    if (prefix == NULL || strlen(prefix) + 12 > sizeof(g_prefix)) {
+        return -1;
+    }
+    if (mode > EVENT_REPLAY_VIRTUAL || (mode == EVENT_REPLAY_SCALED && !(speed > 0))) {
+        return -1;
+    }
+    segment_unmap();
+    if (mode == EVENT_REPLAY_VIRTUAL && !g_clock_saved) {
+        g_saved_clock = EVENT_GetClock(&g_saved_clock_arg);
+        g_clock_saved = 1;
+        EVENT_SetClock(EVENT_VirtualClock, NULL);
+    }
+    strcpy(g_prefix, prefix);
+    g_mode = (uint8_t)mode;
+    g_speed = speed;
+    g_started = 0;
+    g_retries = 0;
+    g_skipped = 0;
+    if (segment_map(0) != 0) {
+        EVENT_ReplayClose();
+        return -1;
+    }
+    return 0;
+}
+
+int EVENT_ReplayPoll(void)
+{
+    int count = 0;
+    const Event_t* rec;
+    while ((rec = next_record()) != NULL) {
+        if (!g_started) {
+            g_base_timestamp = rec->timestamp;
+            g_base_ms = now_ms();
+        } else if (g_mode <= EVENT_REPLAY_SCALED && due_ms(rec) > now_ms()) {
+            return count;       // 尚未到期
+        }
+        if (g_mode == EVENT_REPLAY_VIRTUAL) {
+            EVENT_VirtualClockSet(rec->timestamp);
+        }
+        if (replay_publish(rec) != 0) {
+            if (EVENT_GetCount() >= EVENT_QUEUE_SIZE && ++g_retries <= EVENT_REPLAY_RETRY_MAX) {
+                return count;   // 队列满，分发后再试
+            }
+            g_skipped++;        // 被永久拒绝或重试超限
+        } else {
+            count++;
+        }
+        g_started = 1;
+        g_retries = 0;
+        g_offset += EVENT_JOURNAL_RECORD_SIZE(rec->data_size);
+    }
+    return count > 0 ? count : -1;
+}
+
+int EVENT_ReplayClose(void)
+{
+    segment_unmap();
+    if (g_clock_saved) {
+        EVENT_SetClock(g_saved_clock, g_saved_clock_arg);
+        g_clock_saved = 0;
+    }
+    return 0;
+}
+
+uint32_t EVENT_ReplayGetSkipped(void)
+{
+    return g_skipped;
+}
+
+long EVENT_ReplayRun(const char* prefix, Event_ReplayMode_t mode, double speed)
+{
+    if (EVENT_ReplayOpen(prefix, mode, speed) != 0) {
+        return -1;
+    }
+    long total = 0;
+    int n;
+    while ((n = EVENT_ReplayPoll()) >= 0) {
+        total += n;
+        if (EVENT_Process() == 0 && n == 0) {
+            /* 队列已空而下一条未到期，睡到它的计划时间 */
+            const Event_t* rec = next_record();
+            double wait = (rec && g_mode <= EVENT_REPLAY_SCALED) ? due_ms(rec) - now_ms() : 0;
+            if (wait > 0) {
+                struct timespec ts;
+                ts.tv_sec = (time_t)(wait / 1e3);
+                ts.tv_nsec = (long)((wait - ts.tv_sec * 1e3) * 1e6);
+                nanosleep(&ts, NULL);
+            }
+        }
+    }
+    while (EVENT_Process() > 0) {
+    }
+    EVENT_ReplayClose();
+    return total;
+}
+
+#else
+int EVENT_ReplayOpen(const char* prefix, Event_ReplayMode_t mode, double speed)
+{
+    (void)prefix;
+    (void)mode;
+    (void)speed;
+    return -1;      // Windows 下暂不支持
+}
+
+int EVENT_ReplayPoll(void)
+{
+    return -1;
+}
+
+int EVENT_ReplayClose(void)
+{
+    return -1;
+}
+
+uint32_t EVENT_ReplayGetSkipped(void)
+{
+    return 0;
+}
+
+long EVENT_ReplayRun(const char* prefix, Event_ReplayMode_t mode, double speed)
+{
+    (void)prefix;
+    (void)mode;
+    (void)speed;
+    return -1;
+}
+#endif
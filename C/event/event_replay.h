@@ -0,0 +1,57 @@
+/* event_replay.h
+ * 日志回放：读取 event_journal 写出的段文件，经正常的 EVENT_Publish 路径重新发布
+ * 可按原始时间间隔、按倍率缩放或尽快发布，用于以真实流量评估订阅者改动、复现延迟尖峰
+ *
+ *   EVENT_ReplayOpen("logs/bus", EVENT_REPLAY_SCALED, 10.0);   // 10 倍速
+ *   while (EVENT_ReplayPoll() >= 0) {
+ *       EVENT_Process();
+ *   }
+ *   EVENT_ReplayClose();
+ *
+ * 或在单线程中直接 EVENT_ReplayRun(...)，它在发布之间调用 EVENT_Process
+ * 除 EVENT_REPLAY_VIRTUAL 外，重新发布的事件带有新的时间戳，截止时间随之平移、与时间戳的间隔不变；回放线程即发布线程，须遵守队列的单生产者约定
+ * 仅适用于 POSIX 系统，Windows 下各接口返回 -1
+ */
+
+#ifndef __EVENT_REPLAY_H
+#define __EVENT_REPLAY_H
+
+#include "event_journal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef EVENT_REPLAY_RETRY_MAX
+#define EVENT_REPLAY_RETRY_MAX  1000  // 同一条记录连续发布失败的最大重试次数，超过后跳过
+#endif
+
+typedef enum {
+    EVENT_REPLAY_ORIGINAL = 0,    /* 按记录时的时间间隔发布 */
+    EVENT_REPLAY_SCALED,          /* 间隔除以 speed，speed 为 2.0 即两倍速 */
+    EVENT_REPLAY_FAST,            /* 不等待，队列有空位就发布 */
+    EVENT_REPLAY_VIRTUAL          /* 不等待，发布前把虚拟时钟拨到记录的时间戳：
+                                     事件保留原时间戳，基于时间的逻辑按记录时的节奏运行 */
+} Event_ReplayMode_t;
+
+/* 从 0 号段开始回放，speed 仅在 EVENT_REPLAY_SCALED 下使用且须大于 0
+ * EVENT_REPLAY_VIRTUAL 会通过 EVENT_SetClock 把总线切换到虚拟时钟，EVENT_ReplayClose 时恢复原来的时钟 */
+int EVENT_ReplayOpen(const char* prefix, Event_ReplayMode_t mode, double speed);
+
+/* 发布所有已到期的记录，返回本次发布的数量，日志读完或未打开时返回 -1
+ * 发布失败时，只有队列满才留到下次重试，同一条记录最多重试 EVENT_REPLAY_RETRY_MAX 次；
+ * 其他失败（限流 DROP、没有信用等）视为被拒绝，跳过该记录并计数 */
+int EVENT_ReplayPoll(void);
+uint32_t EVENT_ReplayGetSkipped(void);     // 被拒绝或重试超限而跳过的记录数
+
+int EVENT_ReplayClose(void);
+
+/* 单线程回放整份日志：发布与 EVENT_Process 交替进行，未到期时休眠
+ * 返回发布的事件总数，打开失败返回 -1 */
+long EVENT_ReplayRun(const char* prefix, Event_ReplayMode_t mode, double speed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_REPLAY_H */
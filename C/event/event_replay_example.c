@@ -0,0 +1,93 @@
+/* event_replay_example.c
+ * 记录与回放示例：先把一段事件流写入日志，再从日志回放，检查两次收到的事件完全一致，
+ * 再用虚拟时钟回放，检查时间戳也与记录时相同；最后对告警限流，检查被拒绝的记录被跳过而回放正常结束
+ * 编译：gcc -std=c99 event.c event_journal.c event_replay.c event_replay_example.c -o event_replay_example
+ * 仅适用于 POSIX 系统，日志写在当前目录下的 replay_demo.*.evj
+ */
+
+#include "event_replay.h"
+#include <stdio.h>
+#include <string.h>
+
+#define JOURNAL_PREFIX  "replay_demo"
+#define EVENT_SAMPLE    1
+#define EVENT_ALARM     2
+#define SAMPLE_TOTAL    5000
+
+static uint32_t g_count;
+static uint32_t g_checksum;
+static uint32_t g_time_checksum;
+
+/* 对收到的类型和数据做简单的滚动校验 */
+static void on_any(Event_t* event, void* arg)
+{
+    (void)arg;
+    g_checksum = g_checksum * 31 + event->type;
+    for (uint8_t i = 0; i < event->data_size; i++) {
+        g_checksum = g_checksum * 31 + event->data[i];
+    }
+    g_time_checksum = g_time_checksum * 31 + event->timestamp;
+    g_count++;
+}
+
+static void reset_stats(void)
+{
+    g_count = 0;
+    g_checksum = 0;
+    g_time_checksum = 0;
+}
+
+int main(void)
+{
+    EVENT_Init();
+    EVENT_Subscribe(EVENT_SAMPLE, on_any, NULL);
+    EVENT_Subscribe(EVENT_ALARM, on_any, NULL);
+
+    /* 1. 记录 */
+    if (EVENT_JournalOpen(JOURNAL_PREFIX) != 0) {
+        printf("打开日志失败\n");
+        return 1;
+    }
+    EVENT_RegisterObserver(EVENT_JournalObserver, NULL);
+    reset_stats();
+    for (uint32_t i = 0; i < SAMPLE_TOTAL; i++) {
+        if (i % 100 == 99) {
+            EVENT_Publish(EVENT_ALARM, 2, NULL, 0);
+        } else {
+            EVENT_Publish(EVENT_SAMPLE, 0, &i, sizeof(i));
+        }
+        EVENT_Process();
+    }
+    EVENT_UnregisterObserver(EVENT_JournalObserver);
+    EVENT_JournalClose();
+    uint32_t recorded_count = g_count;
+    uint32_t recorded_checksum = g_checksum;
+    uint32_t recorded_time_checksum = g_time_checksum;
+    printf("记录：%u 个事件，校验值 %08x\n", recorded_count, recorded_checksum);
+
+    /* 2. 尽快回放 */
+    reset_stats();
+    long replayed = EVENT_ReplayRun(JOURNAL_PREFIX, EVENT_REPLAY_FAST, 0);
+    printf("回放：%ld 个事件，校验值 %08x：%s\n", replayed, g_checksum,
+           (g_count == recorded_count && g_checksum == recorded_checksum) ? "通过" : "失败");
+
+    /* 3. 虚拟时钟回放：事件的时间戳也应与记录时一致 */
+    reset_stats();
+    replayed = EVENT_ReplayRun(JOURNAL_PREFIX, EVENT_REPLAY_VIRTUAL, 0);
+    printf("虚拟时钟回放：%ld 个事件，时间戳%s：%s\n", replayed,
+           g_time_checksum == recorded_time_checksum ? "一致" : "不一致",
+           (g_checksum == recorded_checksum && g_time_checksum == recorded_time_checksum) ? "通过" : "失败");
+
+    /* 4. 告警限流为丢弃：被拒绝的记录跳过并计数，回放照常结束，结束后恢复原来的时钟 */
+    EventRateLimit_t limit = { 1, 1, EVENT_RATE_DROP, 0 };
+    EVENT_SetRateLimit(EVENT_ALARM, 0xFFFF, &limit);
+    reset_stats();
+    replayed = EVENT_ReplayRun(JOURNAL_PREFIX, EVENT_REPLAY_VIRTUAL, 0);
+    EventRateStats_t stats;
+    EVENT_GetRateStats(EVENT_ALARM, 0xFFFF, &stats);
+    printf("限流回放：发布 %ld 个，跳过 %u 个，时钟%s恢复：%s\n", replayed, EVENT_ReplayGetSkipped(),
+           EVENT_GetClock(NULL) == NULL ? "已" : "未",
+           (replayed + EVENT_ReplayGetSkipped() == recorded_count && EVENT_ReplayGetSkipped() == stats.dropped &&
+            stats.dropped > 0 && EVENT_GetClock(NULL) == NULL) ? "通过" : "失败");
+    return 0;
+}
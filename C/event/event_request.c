@@ -0,0 +1,219 @@
+/* event_request.c
+ * 请求/应答
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L     /* sched_yield */
+#endif
+
+#include "event_request.h"
+#include <string.h>
+#if !defined(_WIN32)
+#include <sched.h>
+#else
+#include <windows.h>
+#endif
+
+/* 等待表：关联 ID 的低位就是槽位号，高位是分配序号，过期的应答因 ID 不符被忽略 */
+typedef struct {
+    EventReplyCallback_t callback;      /* NULL 表示空闲 */
+    void* arg;
+    uint32_t deadline;
+    uint16_t id;
+    uint8_t has_deadline;
+} PendingRequest_t;
+
+static PendingRequest_t g_pending[EVENT_REQUEST_MAX];
+static uint16_t g_sequence = 0;
+static int      g_timer = -1;           /* 超时检查定时器，-1 表示未启动 */
+static uint32_t g_timer_due;
+
+/* 释放槽位后再回调，回调中可以发起新的请求 */
+static void request_complete(PendingRequest_t* p, Event_ReplyStatus_t status,
+                             const void* data, uint8_t data_size)
+{
+    EventReplyCallback_t callback = p->callback;
+    void* arg = p->arg;
+    p->callback = NULL;
+    callback(status, data, data_size, arg);
+}
+
+static void on_timer(void* arg);
+
+/* 让定时器对准最早的截止时间，没有带超时的请求时停止定时器 */
+static void timer_rearm(void)
+{
+    uint32_t now = EVENT_GetTime();
+    uint32_t best = 0;
+    int found = 0;
+    for (int i = 0; i < EVENT_REQUEST_MAX; i++) {
+        const PendingRequest_t* p = &g_pending[i];
+        if (p->callback != NULL && p->has_deadline &&
+            (!found || (int32_t)(p->deadline - now) < (int32_t)(best - now))) {
+            best = p->deadline;
+            found = 1;
+        }
+    }
+    if (g_timer >= 0 && (!found || best != g_timer_due)) {
+        EVENT_TimerStop(g_timer);
+        g_timer = -1;
+    }
+    if (found && g_timer < 0) {
+        int32_t delay = (int32_t)(best - now);
+        g_timer = EVENT_TimerStart(delay > 0 ? (uint32_t)delay : 0, 0, on_timer, NULL);
+        g_timer_due = best;
+    }
+}
+
+static void on_timer(void* arg)
+{
+    (void)arg;
+    g_timer = -1;       // 单次定时器，回调时已释放
+    uint32_t now = EVENT_GetTime();
+    for (int i = 0; i < EVENT_REQUEST_MAX; i++) {
+        PendingRequest_t* p = &g_pending[i];
+        if (p->callback != NULL && p->has_deadline && (int32_t)(now - p->deadline) >= 0) {
+            request_complete(p, EVENT_REPLY_TIMEOUT, NULL, 0);
+        }
+    }
+    timer_rearm();
+}
+
+/* 应答类型的唯一订阅者：由关联 ID 直接找到槽位 */
+static void on_reply(Event_t* event, void* arg)
+{
+    (void)arg;
+    if (event->data_size < EVENT_REQUEST_HEADER_SIZE) {
+        return;
+    }
+    uint16_t id = (uint16_t)(event->data[0] | (event->data[1] << 8));
+    PendingRequest_t* p = &g_pending[id & (EVENT_REQUEST_MAX - 1)];
+    if (p->callback == NULL || p->id != id) {
+        return;     // 已超时或已取消
+    }
+    request_complete(p, EVENT_REPLY_OK, EVENT_REQUEST_DATA(event), EVENT_REQUEST_SIZE(event));
+}
+
+static void future_complete(Event_ReplyStatus_t status, const void* data, uint8_t data_size, void* arg)
+{
+    EventFuture_t* future = (EventFuture_t*)arg;
+    future->data_size = 0;
+    if (status == EVENT_REPLY_OK && data_size > 0) {
+        memcpy(future->data, data, data_size);
+        future->data_size = data_size;
+    }
+    future->status = (uint8_t)status;
+}
+
+/* 按 [关联 ID][数据] 的格式发布，用于请求和应答 */
+static int publish_with_id(Event_Type_t type, uint16_t id, const void* data, uint8_t data_size)
+{
+    uint8_t buf[EVENT_DATA_SIZE_MAX];
+    buf[0] = (uint8_t)id;
+    buf[1] = (uint8_t)(id >> 8);
+    if (data && data_size > 0) {
+        memcpy(buf + EVENT_REQUEST_HEADER_SIZE, data, data_size);
+    } else {
+        data_size = 0;
+    }
+    return EVENT_Publish(type, 0, buf, (uint8_t)(data_size + EVENT_REQUEST_HEADER_SIZE));
+}
+
+int EVENT_RequestInit(void)
+{
+    for (int i = 0; i < EVENT_REQUEST_MAX; i++) {
+        if (g_pending[i].callback != NULL) {
+            request_complete(&g_pending[i], EVENT_REPLY_CANCELLED, NULL, 0);
+        }
+    }
+    g_timer = -1;       // EVENT_Init 已清空定时器
+    EVENT_Unsubscribe(EVENT_REPLY_TYPE, on_reply, NULL);
+    return EVENT_Subscribe(EVENT_REPLY_TYPE, on_reply, NULL);
+}
+
+int EVENT_Request(Event_Type_t type, const void* data, uint8_t data_size, uint32_t timeout_ms,
+                  EventReplyCallback_t callback, void* arg)
+{
+    if (callback == NULL || data_size > EVENT_REQUEST_DATA_MAX || type == EVENT_REPLY_TYPE) {
+        return -1;
+    }
+    int slot = -1;
+    for (int i = 0; i < EVENT_REQUEST_MAX; i++) {
+        if (g_pending[i].callback == NULL) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        return -1;
+    }
+    uint16_t id = (uint16_t)(g_sequence++ * EVENT_REQUEST_MAX + slot);
+
+    if (publish_with_id(type, id, data, data_size) != 0) {
+        return -1;
+    }
+    PendingRequest_t* p = &g_pending[slot];
+    p->callback = callback;
+    p->arg = arg;
+    p->id = id;
+    p->has_deadline = (timeout_ms != 0);
+    p->deadline = EVENT_GetTime() + timeout_ms;
+    if (p->has_deadline) {
+        timer_rearm();
+    }
+    return id;
+}
+
+int EVENT_RequestAsync(Event_Type_t type, const void* data, uint8_t data_size, uint32_t timeout_ms,
+                       EventFuture_t* future)
+{
+    if (future == NULL) {
+        return -1;
+    }
+    future->status = EVENT_REPLY_PENDING;
+    future->data_size = 0;
+    int id = EVENT_Request(type, data, data_size, timeout_ms, future_complete, future);
+    if (id < 0) {
+        future->status = EVENT_REPLY_CANCELLED;     // 避免 EVENT_FutureWait 无限等待
+    }
+    return id;
+}
+
+int EVENT_RequestCancel(int id)
+{
+    if (id < 0 || id > 0xFFFF) {
+        return -1;
+    }
+    PendingRequest_t* p = &g_pending[id & (EVENT_REQUEST_MAX - 1)];
+    if (p->callback == NULL || p->id != id) {
+        return -1;
+    }
+    request_complete(p, EVENT_REPLY_CANCELLED, NULL, 0);
+    timer_rearm();
+    return 0;
+}
+
+int EVENT_Reply(const Event_t* request, const void* data, uint8_t data_size)
+{
+    if (request == NULL || request->data_size < EVENT_REQUEST_HEADER_SIZE ||
+        data_size > EVENT_REQUEST_DATA_MAX) {
+        return -1;
+    }
+    uint16_t id = (uint16_t)(request->data[0] | (request->data[1] << 8));
+    return publish_with_id(EVENT_REPLY_TYPE, id, data, data_size);
+}
+
+Event_ReplyStatus_t EVENT_FutureWait(EventFuture_t* future)
+{
+    while (future->status == EVENT_REPLY_PENDING) {
+        if (EVENT_Process() == 0) {
+            /* 队列空闲：让出处理器，等总线唯一的生产者线程发布事件或超时定时器到期 */
+#if !defined(_WIN32)
+            sched_yield();
+#else
+            SwitchToThread();
+#endif
+        }
+    }
+    return (Event_ReplyStatus_t)future->status;
+}
@@ -0,0 +1,92 @@
+/* event_request.h
+ * 请求/应答：在总线上实现类似 RPC 的交互
+ * 请求方发布请求并登记回调或 future，总线分配关联 ID，写在请求数据的前 2 字节；
+ * 服务方用 EVENT_Reply 应答，应答以 EVENT_REPLY_TYPE 发布，按关联 ID 直接定位到等待中的请求，
+ * 不经过观察者或逐个比较；超时由总线定时器检查
+ *
+ *   // 服务方：订阅请求类型
+ *   void on_query(Event_t* e, void* arg) {
+ *       uint16_t key;
+ *       memcpy(&key, EVENT_REQUEST_DATA(e), sizeof(key));
+ *       EVENT_Reply(e, &value, sizeof(value));
+ *   }
+ *   // 请求方
+ *   EVENT_RequestInit();                               // 在 EVENT_Init 之后调用一次
+ *   EVENT_Request(EVENT_QUERY, &key, sizeof(key), 100, on_reply, NULL);
+ *   EventFuture_t f;
+ *   EVENT_RequestAsync(EVENT_QUERY, &key, sizeof(key), 100, &f);
+ *   if (EVENT_FutureWait(&f) == EVENT_REPLY_OK) { ... f.data ... }
+ *
+ * 所有接口须在调用 EVENT_Process 的线程中使用；静态订阅模式下不可用
+ */
+
+#ifndef __EVENT_REQUEST_H
+#define __EVENT_REQUEST_H
+
+#include "event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==================== 配置宏 ==================== */
+#ifndef EVENT_REQUEST_MAX
+#define EVENT_REQUEST_MAX       16        // 同时等待应答的请求数（2 的幂，不超过 256）
+#endif
+#ifndef EVENT_REPLY_TYPE
+#define EVENT_REPLY_TYPE        0xFFFF    // 应答事件使用的类型 ID，保留给本模块
+#endif
+
+EVENT_STATIC_ASSERT((EVENT_REQUEST_MAX & (EVENT_REQUEST_MAX - 1)) == 0 && EVENT_REQUEST_MAX <= 256,
+                    request_max_power_of_two);
+
+/* ==================== 类型定义 ==================== */
+/* 请求/应答事件数据的前 2 字节是关联 ID（小端），其后才是用户数据 */
+#define EVENT_REQUEST_HEADER_SIZE   2
+#define EVENT_REQUEST_DATA_MAX      (EVENT_DATA_SIZE_MAX - EVENT_REQUEST_HEADER_SIZE)
+#define EVENT_REQUEST_DATA(e)       ((e)->data + EVENT_REQUEST_HEADER_SIZE)
+#define EVENT_REQUEST_SIZE(e)       ((uint8_t)((e)->data_size >= EVENT_REQUEST_HEADER_SIZE ? \
+                                     (e)->data_size - EVENT_REQUEST_HEADER_SIZE : 0))
+
+typedef enum {
+    EVENT_REPLY_PENDING = 0,      /* 尚未完成（仅用于 future） */
+    EVENT_REPLY_OK,               /* 收到应答 */
+    EVENT_REPLY_TIMEOUT,          /* 超时未收到应答 */
+    EVENT_REPLY_CANCELLED         /* 被 EVENT_RequestCancel 或 EVENT_RequestInit 取消 */
+} Event_ReplyStatus_t;
+
+/* 应答回调，status 不是 EVENT_REPLY_OK 时 data 为 NULL */
+typedef void (*EventReplyCallback_t)(Event_ReplyStatus_t status, const void* data,
+                                     uint8_t data_size, void* arg);
+
+typedef struct {
+    volatile uint8_t status;             /* Event_ReplyStatus_t */
+    uint8_t data_size;
+    uint8_t data[EVENT_REQUEST_DATA_MAX];
+} EventFuture_t;
+
+/* ==================== 公共API ==================== */
+int EVENT_RequestInit(void);            // 订阅应答类型并清空等待表
+
+/* 发布请求，返回关联 ID（0~65535），失败返回 -1；timeout_ms 为 0 表示不超时 */
+int EVENT_Request(Event_Type_t type, const void* data, uint8_t data_size, uint32_t timeout_ms,
+                  EventReplyCallback_t callback, void* arg);
+int EVENT_RequestAsync(Event_Type_t type, const void* data, uint8_t data_size, uint32_t timeout_ms,
+                       EventFuture_t* future);
+int EVENT_RequestCancel(int id);
+
+/* 服务方在请求回调中应答 */
+int EVENT_Reply(const Event_t* request, const void* data, uint8_t data_size);
+
+/* 循环调用 EVENT_Process 直到 future 完成，返回最终状态；队列空闲时让出处理器
+ * 不能在事件回调中调用
+ * 应答只能来自本线程分发的回调（服务方订阅请求类型、在回调中 EVENT_Reply），或来自总线
+ * 唯一的生产者线程；队列是单生产者的，其他线程不能在等待期间直接发布应答，
+ * 需要跨线程服务时由服务线程经自己的通道（如 event_actor 邮箱、另一条队列）把结果交回生产者线程 */
+Event_ReplyStatus_t EVENT_FutureWait(EventFuture_t* future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_REQUEST_H */
@@ -0,0 +1,86 @@
+/* event_shm_example.c
+ * 跨进程共享队列示例：父进程创建共享内存段并处理事件，子进程挂接同一段后发布事件
+ * 编译：gcc -std=c99 event.c event_shm_example.c -o event_shm_example（旧版 glibc 需加 -lrt）
+ * 仅适用于 POSIX 系统
+ */
+
+#define _XOPEN_SOURCE 600       /* usleep */
+#include "event.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define SHM_NAME        "/event_shm_example"
+#define EVENT_SAMPLE    1
+#define SAMPLE_TOTAL    1000
+
+static int g_received = 0;
+static int g_out_of_order = 0;
+
+static void on_sample(Event_t* event, void* arg)
+{
+    (void)arg;
+    uint32_t seq;
+    memcpy(&seq, event->data, sizeof(seq));
+    if (seq != (uint32_t)g_received) {
+        g_out_of_order++;
+    }
+    g_received++;
+}
+
+/* 子进程：挂接共享段，发布 SAMPLE_TOTAL 个带序号的事件，队列满时稍等重试 */
+static int run_producer(void)
+{
+    EVENT_Init();
+    if (EVENT_ShmOpen(SHM_NAME, 0) != 0) {
+        printf("子进程挂接共享段失败\n");
+        return 1;
+    }
+    for (uint32_t seq = 0; seq < SAMPLE_TOTAL; seq++) {
+        while (EVENT_Publish(EVENT_SAMPLE, 0, &seq, sizeof(seq)) != 0) {
+            usleep(100);
+        }
+    }
+    EVENT_ShmClose();
+    return 0;
+}
+
+int main(void)
+{
+    EVENT_Init();
+    EVENT_ShmUnlink(SHM_NAME);      // 清理上次异常退出留下的段
+    if (EVENT_ShmOpen(SHM_NAME, 1) != 0) {
+        printf("创建共享段失败\n");
+        return 1;
+    }
+    EVENT_Subscribe(EVENT_SAMPLE, on_sample, NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        printf("fork 失败\n");
+        return 1;
+    }
+    if (pid == 0) {
+        _exit(run_producer());
+    }
+
+    while (g_received < SAMPLE_TOTAL) {
+        if (EVENT_Process() == 0) {
+            usleep(100);
+        }
+    }
+    waitpid(pid, NULL, 0);
+
+    /* 本进程已是处理方，不能再向同一个段发布 */
+    int rejected = (EVENT_Publish(EVENT_SAMPLE, 0, NULL, 0) != 0);
+
+    printf("共收到 %d 个事件，顺序错误 %d 个，处理方发布%s：%s\n", g_received, g_out_of_order,
+           rejected ? "被拒绝" : "未被拒绝",
+           (g_received == SAMPLE_TOTAL && g_out_of_order == 0 && rejected) ? "通过" : "失败");
+
+    EVENT_ShmClose();
+    EVENT_ShmUnlink(SHM_NAME);
+    return 0;
+}
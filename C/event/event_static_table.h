@@ -0,0 +1,38 @@
+/* event_static_table.h
+ * 静态订阅表示例，EVENT_STATIC_SUBSCRIPTIONS=1 时由 event.c 包含
+ * 内容与 event_example.c 中的运行期订阅一一对应：
+ * 编译：gcc -std=c99 -DEVENT_STATIC_SUBSCRIPTIONS=1 event.c event_request.c event_aggregate.c \
+ *       event_pipeline.c event_actor.c event_example.c -o event_static
+ * 该模式下 event_example.c 只运行不依赖运行期订阅的演示，并检查运行期订阅接口返回 -1
+ * 回调若以 static inline 形式定义在本文件（或其包含的头文件）中，编译器可直接内联
+ */
+
+#ifndef __EVENT_STATIC_TABLE_H
+#define __EVENT_STATIC_TABLE_H
+
+/* 表中用到的回调与参数 */
+void on_button_press(Event_t* event, void* arg);
+void on_sensor_data(Event_t* event, void* arg);
+void on_system_alert(Event_t* event, void* arg);
+void on_chain_step(Event_t* event, void* arg);
+
+static int g_static_alert_level = 3;
+
+/* BEGIN(类型) 与 END() 之间列出该类型的 HANDLER(回调, 参数)，同一类型只能出现一组；
+ * OBSERVER(回调, 参数) 声明全局观察者，例如 OBSERVER(global_observer, NULL) */
+#define EVENT_STATIC_TABLE(BEGIN, HANDLER, END, OBSERVER)   \
+    BEGIN(1)    /* EVENT_BUTTON_PRESS */                    \
+        HANDLER(on_button_press, "启动按钮")                \
+        HANDLER(on_button_press, "停止按钮")                \
+    END()                                                   \
+    BEGIN(2)    /* EVENT_SENSOR_DATA */                     \
+        HANDLER(on_sensor_data, NULL)                       \
+    END()                                                   \
+    BEGIN(3)    /* EVENT_SYSTEM_ALERT */                    \
+        HANDLER(on_system_alert, &g_static_alert_level)     \
+    END()                                                   \
+    BEGIN(5)    /* EVENT_CHAIN_STEP */                      \
+        HANDLER(on_chain_step, NULL)                        \
+    END()
+
+#endif /* __EVENT_STATIC_TABLE_H */
@@ -0,0 +1,165 @@
+/* event_topic.hpp
+ * 字符串主题名与 Event_Type_t 的编译期映射（C++14，仅头文件）
+ * 主题名在编译期散列成 16 位类型 ID，运行时查找没有任何开销；
+ * 启动时把用到的主题注册一遍，即可检测散列冲突，并在诊断输出中按 ID 取回名称
+ *
+ *   using namespace event::literals;
+ *   constexpr Event_Type_t TOPIC_TEMP = "sensor/temp"_topic;
+ *   event::register_topic("sensor/temp");            // 冲突时返回 -1
+ *   EVENT_Publish(TOPIC_TEMP, 1, &value, sizeof(value));
+ *   printf("%s\n", event::topic_name(event->type));
+ *
+ * 主题 ID 落在 [EVENT_TOPIC_BASE, EVENT_TOPIC_BASE + EVENT_TOPIC_SPAN - 1) 内，默认是 0xF000~0xFFFE，
+ * 区间的最后一个 ID 不用，默认区间下它是 event_request 的应答类型 0xFFFF；
+ * 默认区间是层级主题的第 15 号一级主题：使用散列主题时 EVENT_TOPIC(15, ...) 保留给它们，不要另作他用，
+ * EVENT_SubscribeMask(EVENT_TOPIC(15, 0, 0), EVENT_TOPIC_MASK_L1, ...) 会收到所有散列主题
+ * n 个主题散列进 SPAN 个 ID 至少一次冲突的概率约为 n*n/(2*SPAN)：默认 16 个主题、4096 个 ID 约 3%，
+ * 冲突在编译期（topics_distinct、EventBus）或注册时报告，改 EVENT_TOPIC_SEED 重新散列即可
+ * 每个用到的 256 个 ID 占一页类型索引（EVENT_TYPE_PAGE_MAX），主题多时须相应加大页数
+ */
+
+#ifndef __EVENT_TOPIC_HPP
+#define __EVENT_TOPIC_HPP
+
+#include "event.h"
+#include <cstddef>
+#include <cstring>
+
+#ifndef EVENT_TOPIC_MAX
+#define EVENT_TOPIC_MAX     16        // 可注册的主题名数量，SPAN 须远大于它的平方的一半
+#endif
+#ifndef EVENT_TOPIC_BASE
+#define EVENT_TOPIC_BASE    0xF000    // 主题 ID 区间起点（256 的倍数），默认是层级主题 15/+/+
+#endif
+#ifndef EVENT_TOPIC_SPAN
+#define EVENT_TOPIC_SPAN    4096      // 主题 ID 区间长度（256 的倍数且为 2 的幂）
+#endif
+#ifndef EVENT_TOPIC_SEED
+#define EVENT_TOPIC_SEED    0         // 散列种子，主题冲突时换一个值
+#endif
+
+static_assert(EVENT_TOPIC_BASE % 256 == 0 && EVENT_TOPIC_SPAN % 256 == 0 &&
+              (EVENT_TOPIC_SPAN & (EVENT_TOPIC_SPAN - 1)) == 0 &&
+              EVENT_TOPIC_BASE + EVENT_TOPIC_SPAN <= 0x10000,
+              "event_topic: 主题 ID 区间须按页对齐且不超出 16 位");
+static_assert(EVENT_TOPIC_SPAN >= 8 * EVENT_TOPIC_MAX * EVENT_TOPIC_MAX,
+              "event_topic: 主题 ID 区间相对主题数量过小，冲突会成为常态");
+
+namespace event {
+
+/* FNV-1a 32 位散列 */
+constexpr uint32_t fnv1a(const char* s, std::size_t n)
+{
+    uint32_t h = 2166136261u ^ static_cast<uint32_t>(EVENT_TOPIC_SEED);
+    for (std::size_t i = 0; i < n; i++) {
+        h = (h ^ static_cast<uint8_t>(s[i])) * 16777619u;
+    }
+    return h;
+}
+
+/* 把 32 位散列异或折叠后映射进主题 ID 区间，跳过区间的最后一个 ID */
+constexpr Event_Type_t topic_id(const char* s, std::size_t n)
+{
+    return static_cast<Event_Type_t>(EVENT_TOPIC_BASE +
+        (((fnv1a(s, n) >> 16) ^ (fnv1a(s, n) & 0xFFFF)) % (EVENT_TOPIC_SPAN - 1)));
+}
+
+template <std::size_t N>
+constexpr Event_Type_t topic_id(const char (&name)[N])
+{
+    return topic_id(name, N - 1);
+}
+
+namespace literals {
+constexpr Event_Type_t operator"" _topic(const char* s, std::size_t n)
+{
+    return topic_id(s, n);
+}
+} // namespace literals
+
+/* 编译期检查一组主题 ID 两两不同：
+ *   static_assert(event::topics_distinct("a"_topic, "b"_topic), "主题冲突"); */
+constexpr bool topics_distinct()
+{
+    return true;
+}
+
+template <typename... Rest>
+constexpr bool topics_distinct(Event_Type_t first, Rest... rest)
+{
+    const Event_Type_t ids[] = {static_cast<Event_Type_t>(rest)..., first};
+    for (std::size_t i = 0; i + 1 < sizeof(ids) / sizeof(ids[0]); i++) {
+        if (ids[i] == first) {
+            return false;
+        }
+    }
+    return topics_distinct(rest...);
+}
+
+/* 运行期注册表：开放寻址散列表，以类型 ID 为键保存主题名指针
+ * 只应在启动阶段注册，名称须是静态存储的字符串 */
+class TopicRegistry {
+public:
+    /* 注册成功或重复注册同名主题返回 0，ID 已被其他名称占用或表满返回 -1 */
+    static int add(Event_Type_t id, const char* name)
+    {
+        Entry* table = entries();
+        for (std::size_t i = 0; i < EVENT_TOPIC_MAX; i++) {
+            Entry& e = table[(id + i) % EVENT_TOPIC_MAX];
+            if (e.name == nullptr) {
+                e.id = id;
+                e.name = name;
+                return 0;
+            }
+            if (e.id == id) {
+                return std::strcmp(e.name, name) == 0 ? 0 : -1;
+            }
+        }
+        return -1;
+    }
+
+    /* 查不到时返回 nullptr */
+    static const char* name(Event_Type_t id)
+    {
+        const Entry* table = entries();
+        for (std::size_t i = 0; i < EVENT_TOPIC_MAX; i++) {
+            const Entry& e = table[(id + i) % EVENT_TOPIC_MAX];
+            if (e.name == nullptr) {
+                return nullptr;
+            }
+            if (e.id == id) {
+                return e.name;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct Entry {
+        Event_Type_t id;
+        const char* name;
+    };
+
+    static Entry* entries()
+    {
+        static Entry table[EVENT_TOPIC_MAX];
+        return table;
+    }
+};
+
+template <std::size_t N>
+inline int register_topic(const char (&name)[N])
+{
+    return TopicRegistry::add(topic_id(name), name);
+}
+
+/* 诊断用：返回注册过的主题名，未注册时返回 "?" */
+inline const char* topic_name(Event_Type_t id)
+{
+    const char* name = TopicRegistry::name(id);
+    return name ? name : "?";
+}
+
+} // namespace event
+
+#endif /* __EVENT_TOPIC_HPP */
@@ -0,0 +1,61 @@
+/* event_topic_example.cpp
+ * 字符串主题示例：主题 ID 的取值区间、编译期与注册时的冲突检测、按 ID 取回名称
+ * 编译：g++ -std=c++14 event_topic_example.cpp -o event_topic_example
+ */
+
+#include "event_topic.hpp"
+#include <cstdio>
+
+using namespace event::literals;
+
+constexpr Event_Type_t TOPIC_TEMP = "sensor/temp"_topic;
+constexpr Event_Type_t TOPIC_HUMI = "sensor/humi"_topic;
+
+/* 默认种子与区间下这两个名称散列到同一 ID */
+constexpr Event_Type_t TOPIC_CLASH_A = "sensor/41"_topic;
+constexpr Event_Type_t TOPIC_CLASH_B = "sensor/116"_topic;
+
+static_assert(event::topics_distinct(TOPIC_TEMP, TOPIC_HUMI), "主题冲突");
+#if EVENT_TOPIC_SEED == 0 && EVENT_TOPIC_BASE == 0xF000 && EVENT_TOPIC_SPAN == 4096
+static_assert(!event::topics_distinct(TOPIC_TEMP, TOPIC_CLASH_A, TOPIC_CLASH_B),
+              "编译期应检测到冲突");
+#endif
+
+int main()
+{
+    int pass = 1;
+
+    /* 1. ID 落在保留的区间内，属于一级主题 15，且不会是应答类型 0xFFFF */
+    const Event_Type_t ids[] = {TOPIC_TEMP, TOPIC_HUMI, TOPIC_CLASH_A, TOPIC_CLASH_B};
+    bool in_span = true;
+    for (Event_Type_t id : ids) {
+        in_span = in_span && id >= EVENT_TOPIC_BASE && id < EVENT_TOPIC_BASE + EVENT_TOPIC_SPAN - 1 &&
+                  (id & EVENT_TOPIC_MASK_L1) == EVENT_TOPIC(15, 0, 0);
+    }
+    printf("sensor/temp = 0x%04X，sensor/humi = 0x%04X，都在主题区间内：%s\n",
+           TOPIC_TEMP, TOPIC_HUMI, in_span ? "是" : "否");
+    pass &= in_span;
+
+    /* 2. 注册：新名称成功，同名重复注册成功，冲突的名称被拒绝 */
+    int temp = event::register_topic("sensor/temp");
+    int again = event::register_topic("sensor/temp");
+    int humi = event::register_topic("sensor/humi");
+    int clash_a = event::register_topic("sensor/41");
+    int clash_b = event::register_topic("sensor/116");
+    printf("注册 temp %d，重复 %d，humi %d，sensor/41 %d，sensor/116（0x%04X 已被占用）%d\n",
+           temp, again, humi, clash_a, TOPIC_CLASH_B, clash_b);
+    pass &= (temp == 0 && again == 0 && humi == 0 && clash_a == 0);
+    pass &= (TOPIC_CLASH_A != TOPIC_CLASH_B || clash_b == -1);
+
+    /* 3. 按 ID 取回名称，冲突的 ID 保留先注册的名称 */
+    printf("0x%04X -> %s，0x%04X -> %s，未注册 -> %s\n",
+           TOPIC_TEMP, event::topic_name(TOPIC_TEMP),
+           TOPIC_CLASH_B, event::topic_name(TOPIC_CLASH_B),
+           event::topic_name(EVENT_TOPIC(1, 0, 0)));
+    pass &= (std::strcmp(event::topic_name(TOPIC_TEMP), "sensor/temp") == 0 &&
+             std::strcmp(event::topic_name(TOPIC_CLASH_A), "sensor/41") == 0 &&
+             std::strcmp(event::topic_name(EVENT_TOPIC(1, 0, 0)), "?") == 0);
+
+    printf("%s\n", pass ? "通过" : "失败");
+    return 0;
+}